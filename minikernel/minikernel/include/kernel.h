@@ -25,10 +25,123 @@
 /* Incluimos la librería string.h */
 #include "string.h"
 
+/* Incluimos la librería stdlib.h para leer la política de planificación */
+#include <stdlib.h>
+
+/* Incluimos la librería time.h para medir el arranque de los procesos */
+#include <time.h>
+
 /* Constantes que referencian el tipo del mutex */
 #define NO_RECURSIVO 0
 #define RECURSIVO 1
 
+/* Constantes del round robin con rodaja adaptativa */
+#define RODAJA_MIN 2			/* Rodaja mínima en TICKs */
+#define RODAJA_MAX (8*TICKS_POR_RODAJA)	/* Rodaja máxima en TICKs */
+#define QUANTUM_HIST 8			/* Rodajas que se guardan en el historial */
+
+/* Constantes de la planificación multinivel con realimentación (MLFQ) */
+#define MLFQ_LEVELS 3			/* Número de colas de listos */
+#define MLFQ_BOOST_TICKS (5*TICK)	/* Periodo de subida de todos los procesos al nivel 0 */
+
+/* Constantes de la planificación por prioridades estáticas */
+#define NUM_PRIORIDADES 8		/* Prioridades 0 (máxima) a NUM_PRIORIDADES-1 */
+#define PRIORIDAD_DEFECTO 4		/* Prioridad del proceso inicial */
+
+/* Una cola de listos por prioridad y nivel; debe caber en un mapa de 32 bits */
+#define NUM_COLAS_LISTOS (NUM_PRIORIDADES*MLFQ_LEVELS)
+
+/* Constantes de la planificación por tiempo virtual (CFS) */
+#define CFS_PESO_BASE 1024		/* Peso de la prioridad por defecto */
+#define CFS_GRANULARIDAD 3		/* TICKs de ventaja antes de expulsar */
+
+/* Constantes de la planificación proporcional (stride y lotería) */
+#define TICKETS_DEFECTO 100		/* Tickets del proceso inicial */
+#define MAX_TICKETS 10000		/* Máximo de tickets de un proceso */
+#define STRIDE1 (1 << 20)		/* Numerador del stride */
+
+/* Constantes de la clase de tiempo real (EDF) */
+#define RT_UTIL_MAX 900			/* Utilización máxima admitida en tanto por mil */
+
+/* Constantes de la rueda jerárquica de temporización */
+#define RUEDA_NIVELES 4			/* Niveles de la rueda */
+#define RUEDA_BITS 6			/* Bits del TICK que indexa cada nivel */
+#define RUEDA_RANURAS (1 << RUEDA_BITS)	/* Ranuras por nivel */
+#define RUEDA_MASCARA (RUEDA_RANURAS - 1)
+#define RUEDA_MAX_DELTA ((1ULL << (RUEDA_NIVELES*RUEDA_BITS)) - 1)	/* Mayor distancia representable */
+
+/* Frecuencia de reloj dinámica */
+#define TICK_LENTO 10			/* Frecuencia reducida; debe dividir a TICK */
+#define RELOJ_ENV "MINIKERNEL_RELOJ"	/* fijo o dinamico */
+
+/* Constantes de los temporizadores periódicos */
+#define MAX_TEMPORIZADORES 16		/* Temporizadores en el sistema */
+
+/* Constantes de los grupos de procesos con cuota de UCP */
+#define MAX_GRUPOS 8			/* Grupos, incluido el grupo 0 sin límite */
+
+/* Tabla de procesos ampliable; MAX_PROC, de const.h, es el menor límite admitido */
+#define BLOQUE_PROCS 64			/* Entradas que se añaden al crecer; una palabra del mapa */
+#define MAX_PROC_TOPE 16384		/* Mayor límite configurable; múltiplo de 64*BLOQUE_PROCS */
+#define MAX_PROC_DEFECTO 4096		/* Límite si no se indica otro */
+#define MAX_PROC_ENV "MINIKERNEL_MAX_PROC"	/* Variable de entorno con el límite */
+#define NUM_BLOQUES_PROCS (MAX_PROC_TOPE/BLOQUE_PROCS)
+#define NUM_GENERACIONES (0x7fffffff/MAX_PROC_TOPE)	/* Para que el pid quepa en un int */
+
+/* Reserva de pilas de los procesos terminados */
+#define RESERVA_PILAS_DEFECTO 16	/* Pilas libres que se guardan como máximo */
+#define RESERVA_PILAS_TOPE 256		/* Mayor máximo configurable */
+#define RESERVA_PILAS_ENV "MINIKERNEL_RESERVA_PILAS"	/* Variable de entorno con el máximo */
+
+/* Caché de imágenes de los programas */
+#define TABLA_IMAGENES 32		/* Programas distintos que se siguen a la vez */
+#define MAX_NOM_PROG 32			/* Longitud máxima de un nombre que se guarda */
+#define CACHE_IMAGENES_DEFECTO 0	/* Desactivada salvo que se pida */
+#define CACHE_IMAGENES_ENV "MINIKERNEL_CACHE_IMAGENES"	/* Variable de entorno con el máximo */
+
+/* Liberación diferida de los procesos terminados */
+#define TERMINANDO 4			/* Estado: terminado con recursos sin liberar */
+#define ZOMBI 5				/* Estado: terminado a la espera de que su padre lo recoja */
+#define RECOGER_POR_TICK 4		/* Procesos que se liberan como mucho en cada TICK */
+#define SALIDA_EXCEPCION -1		/* Estado de salida de un proceso que provoca una excepción */
+
+/* Carga diferida de los programas hasta que el proceso va a ejecutar */
+#define CARGA_DIFERIDA_ENV "MINIKERNEL_CARGA_DIFERIDA"	/* Variable de entorno; 1 la activa */
+#define SALIDA_CARGA -2			/* Estado de salida de un proceso cuyo programa no se carga */
+
+/* Tabla de descriptores de cada proceso; empieza con NUM_MUT_PROC entradas,
+	de const.h, y crece si hacen falta más */
+#define DESCRIPTORES_TOPE 4096		/* Descriptores abiertos como mucho por un proceso */
+#define DESC_LIBRE 0			/* Tipos de objeto al que apunta un descriptor */
+#define DESC_MUTEX 1
+
+/* Tabla de mutex e índice de sus nombres; NUM_MUT, de const.h, es el tamaño
+	por defecto y el mínimo */
+#define MAX_MUTEX_TOPE 65536		/* Mayor número de mutex configurable */
+#define MAX_MUTEX_ENV "MINIKERNEL_MAX_MUTEX"	/* Variable de entorno con el número de mutex */
+
+/* Selección de la política de planificación en el arranque */
+#define PLANIF_ENV "MINIKERNEL_PLANIF"	/* Variable de entorno con el nombre */
+#define PLANIF_DEFECTO "mlfq"		/* Política si no se indica otra */
+
+/* Reglas de expulsión al despertar un proceso, combinables */
+#define EXPULSION_NUNCA 0		/* El proceso despertado espera su turno */
+#define EXPULSION_SUENO 1		/* Expulsa si ha estado bloqueado mucho tiempo */
+#define EXPULSION_URGENCIA 2		/* Expulsa si la política lo prefiere al actual */
+#define EXPULSION_SUENO_MIN TICKS_POR_RODAJA	/* TICKs bloqueado para la regla de sueño */
+
+/* Selección de la regla de expulsión en el arranque */
+#define EXPULSION_ENV "MINIKERNEL_EXPULSION"	/* nunca, sueno, urgencia o ambas */
+#define EXPULSION_DEFECTO EXPULSION_URGENCIA
+
+/* Listas en las que un BCP puede estar a la vez; cada una usa su enlace */
+#define ENLACE_LISTOS 0			/* Colas de listos y de apartados */
+#define ENLACE_RUEDA 1			/* Ranuras de la rueda de temporización */
+#define ENLACE_ESPERA 2			/* Colas de espera de los mutex */
+#define ENLACE_DONACION 3		/* Dueños de mutex con rodaja prestada */
+#define ENLACE_GRUPO 4			/* Miembros de un grupo con cuota */
+#define NUM_ENLACES 5
+
 /*
  *
  * Definicion del tipo que corresponde con el BCP.
@@ -37,33 +150,113 @@
  */
 typedef struct BCP_t *BCPptr;
 
+/*
+ *
+ * Definicion del tipo que corresponde con la cabecera de una lista
+ * de BCPs. Este tipo se puede usar para diversas listas (procesos listos,
+ * procesos bloqueados en sem�foro, etc.).
+ * Es doblemente enlazada y los enlaces están en el propio BCP, uno por
+ * tipo de lista, así que un proceso puede estar en una lista de cada tipo.
+ *
+ */
+
+typedef struct{
+	BCPptr primero;
+	BCPptr ultimo;
+	int enlace;		/* ENLACE_* que usan sus BCPs; 0 por defecto */
+} lista_BCPs;
+
+/*
+ * Entrada de la tabla de descriptores de un proceso. Las libres se
+ * encadenan por objeto.
+ */
+typedef struct{
+	int tipo;		/* DESC_LIBRE|DESC_MUTEX */
+	int objeto;		/* Entrada del objeto o siguiente libre */
+} descriptor;
+
 typedef struct BCP_t {
         int id;				/* ident. del proceso */
-        int estado;			/* TERMINADO|LISTO|EJECUCION|BLOQUEADO*/
+        int ranura;			/* entrada que ocupa en la tabla */
+        unsigned int generacion;	/* ocupaciones previas de la entrada */
+        int estado;			/* TERMINADO|LISTO|EJECUCION|BLOQUEADO|TERMINANDO|ZOMBI */
         contexto_t contexto_regs;	/* copia de regs. de UCP */
         void * pila;			/* dir. inicial de la pila */
-		BCPptr siguiente;		/* puntero a otro BCP */
+		struct {
+			BCPptr siguiente;	/* BCP posterior en la lista */
+			BCPptr anterior;	/* BCP anterior en la lista */
+		} enlaces[NUM_ENLACES];	/* uno por cada tipo de lista */
 		void *info_mem;			/* descriptor del mapa de memoria */
 
 		/* Elementos necesarios para la llamada dormir */
-		unsigned int seconds;	/* Tiempo de bloqueo del proceso */
+		unsigned long long despertar;	/* TICK absoluto en que debe despertar */
+		unsigned long long orden_sueno;	/* Orden de llegada a la rueda */
+		unsigned long long despertar_pedido;	/* TICK pedido, sin la holgura */
+		unsigned int holgura;		/* TICKs que puede retrasarse su despertar */
+
+		/* Elementos necesarios para la planificación */
+		int robin_seconds;		/* TICKs que le quedan de rodaja */
+		unsigned int quantum;	/* Rodaja adaptativa actual en TICKs */
+		unsigned int quantum_hist[QUANTUM_HIST];	/* Últimas rodajas asignadas */
+		int quantum_hist_pos;	/* Siguiente posición del historial */
+		int level;				/* Nivel de la cola multinivel (0 = más prioritario) */
+		int priority;			/* Prioridad estática (0 = más prioritaria) */
+		unsigned long long vruntime;	/* Tiempo virtual de ejecución (CFS) */
+		int heap_pos;			/* Posición en el montículo CFS (-1 si no está) */
+		unsigned int tickets;	/* Tickets del reparto proporcional */
+		unsigned long long ticks_cpu;	/* TICKs ejecutados desde su creación */
+		unsigned long long ticks_inicio;	/* Valor de ticks_ocupados al crearse */
+		unsigned long long ticks_bloqueo;	/* TICK en que se bloqueó por última vez */
+		unsigned long long arranque_ns;	/* Instante de creación; 0 tras su primera llamada */
+		int imagen;			/* Entrada de la caché de imágenes; -1 si no está */
+		int carga_pendiente;		/* Su programa se carga al elegirlo para ejecutar */
+		char programa[MAX_NOM_PROG];	/* Programa que se carga de forma diferida */
+
+		/* Elementos necesarios para la clase de tiempo real (EDF) */
+		unsigned int rt_period;	/* Periodo en TICKs (0 = no es de tiempo real) */
+		unsigned int rt_budget;	/* TICKs de UCP por periodo */
+		unsigned int rt_deadline;	/* Plazo relativo al inicio del periodo */
+		unsigned int rt_util;	/* Utilización admitida en tanto por mil */
+		unsigned long long rt_release;	/* TICK de inicio del periodo actual */
+		unsigned long long rt_abs_deadline;	/* Plazo absoluto del trabajo actual */
+		int rt_budget_left;		/* Presupuesto que le queda en el periodo */
+		int rt_throttled;		/* Ha agotado el presupuesto del periodo */
+		int rt_job_done;		/* Ha terminado el trabajo del periodo */
+		int rt_missed;			/* Ya se contó el fallo del trabajo actual */
+		int rt_misses;			/* Plazos incumplidos */
+
+		/* Elementos necesarios para la cuota de UCP por grupos */
+		int grupo;			/* Grupo al que pertenece */
+
+		/* Elementos necesarios para esperar a los hijos */
+		int padre;			/* Proceso que lo creó; -1 si nadie lo va a esperar */
+		int codigo_salida;		/* Estado con el que terminó */
+		lista_BCPs esperando;		/* Padre esperando a que termine (ENLACE_ESPERA) */
+		lista_BCPs zombis;		/* Hijos terminados sin recoger (ENLACE_LISTOS) */
 
 		/* Elementos necesarios para la realización del mutex */
-		int descriptor[NUM_MUT_PROC]; /* Descriptores de mutex */
+		descriptor *descriptores;	/* Tabla de descriptores; crece al llenarse */
+		int num_descriptores;		/* Entradas de la tabla */
+		int descriptor_libre;		/* Primera entrada libre o -1 */
+		int rodaja_prestada;		/* TICKs prestados al dueño del mutex que espera */
+		int donacion;			/* TICKs prestados que le quedan por consumir */
+		int donado_total;		/* TICKs prestados por los que esperan sus mutex */
 } BCP;
 
 /*
- *
- * Definicion del tipo que corresponde con la cabecera de una lista
- * de BCPs. Este tipo se puede usar para diversas listas (procesos listos,
- * procesos bloqueados en sem�foro, etc.).
- *
+ * Tabla de operaciones de una política de planificación. El proceso en
+ * ejecución sigue en la estructura de listos mientras ocupa la UCP.
  */
-
 typedef struct{
-	BCP *primero;
-	BCP *ultimo;
-} lista_BCPs;
+	char *name;				/* Nombre con el que se elige en el arranque */
+	void (*init)(BCP *proc);		/* Inicia los campos de un proceso nuevo */
+	void (*enqueue)(BCP *proc);		/* Inserta en la estructura de listos */
+	void (*dequeue)(BCP *proc);		/* Elimina de la estructura de listos */
+	BCP *(*pick_next)();			/* Siguiente proceso a ejecutar o NULL */
+	int (*tick)(BCP *proc);			/* TICK en ejecución; 1 si debe ceder la UCP */
+	void (*yield)(BCP *proc);		/* Reinserta al proceso que deja la UCP */
+	void (*wakeup)(BCP *proc);		/* Inserta a un proceso que se desbloquea */
+} sched_ops;
 
 /* Definición de la estructura correspondiente al mutex */
 typedef struct{
@@ -73,8 +266,43 @@ typedef struct{
 	int waiting_process_amount;	/* Número de procesos en la lista de espera del mutex */
 	BCPptr lock_process;			/* Proceso usando el mutex */
 	int lock_amount;		/* Veces que ha sido bloqueado el mutex */
+	int descriptor_amount;	/* Descriptores abiertos que referencian al mutex */
+	unsigned int name_hash;	/* Resumen del nombre para el índice */
+	int next;		/* Siguiente en la cadena de su nombre o en la de libres */
+	int donado;		/* TICKs prestados al dueño por los que esperan */
 } mutex;
 
+/* Definición de la estructura correspondiente a una imagen de la caché */
+typedef struct{
+	char nombre[MAX_NOM_PROG];	/* Programa; vacío si la entrada está libre */
+	void *info_mem;			/* Imagen que devolvió crear_imagen */
+	void *pc_inicial;		/* Punto de entrada del programa */
+	int refs;			/* Procesos que la usan */
+	unsigned long long ultimo_uso;	/* Orden en que dejó de usarse */
+} imagen_prog;
+
+/* Definición de la estructura correspondiente a un temporizador periódico */
+typedef struct{
+	BCPptr propietario;		/* Proceso que lo creó; NULL si está libre */
+	unsigned int periodo;		/* Periodo en TICKs */
+	unsigned long long siguiente;	/* TICK absoluto del siguiente vencimiento */
+	unsigned int perdidos;		/* Periodos perdidos desde su creación */
+} temporizador;
+
+/* Definición de la estructura correspondiente a un grupo de procesos */
+typedef struct{
+	unsigned int cuota;		/* TICKs de UCP por periodo; 0 sin límite */
+	unsigned int periodo;		/* Periodo de la cuota en TICKs */
+	unsigned long long inicio_periodo;	/* TICK de inicio del periodo actual */
+	unsigned int consumo;		/* TICKs consumidos en el periodo actual */
+	int estrangulado;		/* Ha agotado la cuota del periodo */
+	int num_procs;			/* Procesos del grupo; 0 si está libre */
+	unsigned int ticks_total;	/* TICKs consumidos desde su creación */
+	unsigned int estrangulamientos;	/* Periodos en que agotó la cuota */
+	lista_BCPs espera;		/* Procesos apartados hasta el siguiente periodo */
+	lista_BCPs miembros;		/* Sus procesos, salvo en el grupo 0 (ENLACE_GRUPO) */
+} grupo;
+
 /*
  * Variable global que identifica el proceso actual
  */
@@ -82,24 +310,185 @@ typedef struct{
 BCP * p_proc_actual=NULL;
 
 /*
- * Variable global que representa la tabla de procesos
+ * Variable global que representa la tabla de procesos. Crece por bloques
+ * de BLOQUE_PROCS entradas que no se mueven una vez reservados.
  */
 
-BCP tabla_procs[MAX_PROC];
+BCP *tabla_procs[NUM_BLOQUES_PROCS];
+int capacidad_procs = 0;		/* Entradas reservadas */
+int limite_procs = MAX_PROC_DEFECTO;	/* Entradas que puede llegar a tener */
+
+/* Mapa de entradas libres (bit j de la palabra i = entrada i*BLOQUE_PROCS+j)
+	y resumen con las palabras que tienen algún bit a 1 */
+unsigned long long mapa_procs_libres[NUM_BLOQUES_PROCS];
+unsigned long long resumen_procs_libres[NUM_BLOQUES_PROCS/64];
 
 /*
- * Variable global que representa la cola de procesos listos
+ * Variable global que representa las colas de procesos listos, una por
+ * prioridad y nivel de la planificación multinivel
  */
-lista_BCPs lista_listos= {NULL, NULL};
+lista_BCPs lista_listos[NUM_COLAS_LISTOS];
+
+/* Mapa de bits de colas de listos no vacías (bit i = lista_listos[i]) */
+unsigned int mapa_listos = 0;
+
+/* Política de planificación elegida en el arranque */
+sched_ops *planif = NULL;
+
+/* Cola de procesos listos de las políticas FIFO y round robin */
+lista_BCPs cola_rr = {NULL, NULL};
+
+/* TICKs transcurridos desde la última subida de prioridad de la MLFQ */
+int ticks_since_boost = 0;
+
+/* Montículo mínimo por vruntime de los procesos listos (CFS) */
+BCP **cfs_heap = NULL;		/* limite_procs elementos */
+int cfs_heap_size = 0;
+
+/* Menor vruntime alcanzado, nunca decrece (CFS y pass global de stride) */
+unsigned long long cfs_min_vruntime = 0;
+
+/* Árbol de Fenwick con los tickets de los procesos listos (lotería) */
+int *lottery_tree = NULL;	/* limite_procs + 1 elementos */
+unsigned int lottery_total = 0;
+unsigned int lottery_seed = 2463534242U;
+
+/* Procesos de tiempo real listos, ordenados por plazo absoluto (EDF) */
+lista_BCPs lista_edf = {NULL, NULL};
+
+/* Procesos de tiempo real que esperan al siguiente periodo */
+lista_BCPs lista_rt_espera = {NULL, NULL};
+
+/* Procesos terminados cuyos recursos están pendientes de liberar */
+lista_BCPs lista_terminados = {NULL, NULL};
+
+/* Zombis de todos los procesos por orden de terminación, para reutilizar
+	sus entradas si se llena la tabla */
+lista_BCPs lista_zombis = {NULL, NULL, ENLACE_ESPERA};
+
+/* Estadísticas de la terminación de procesos */
+unsigned int num_fines = 0;
+unsigned long long fin_total_ns = 0;	/* Desde que termina hasta que ejecuta otro */
+unsigned int num_recogidos = 0;
+unsigned long long recogida_total_ns = 0;	/* Liberando los recursos */
+
+/* Utilización admitida en la clase de tiempo real, en tanto por mil */
+unsigned int rt_utilization = 0;
+
+/* Tabla de temporizadores periódicos */
+temporizador tabla_temporizadores[MAX_TEMPORIZADORES];
+
+/* Tabla de grupos de procesos; el grupo 0 no tiene límite */
+grupo tabla_grupos[MAX_GRUPOS];
+int grupos_con_cuota = 0;		/* Grupos en uso distintos del 0 */
+
+/* Procesos listos o en ejecución */
+int num_listos = 0;
+
+/* Frecuencia de reloj dinámica */
+int reloj_dinamico = 0;			/* Modo elegido en el arranque */
+int ticks_por_int = 1;			/* TICKs que representa cada interrupción */
+unsigned int interrupciones_evitadas = 0;	/* Interrupciones de reloj ahorradas */
+unsigned int ticks_tranquilos = 0;	/* Interrupciones tratadas por el camino rápido */
+
+/* Pilas de procesos terminados listas para reutilizarse */
+void *reserva_pilas[RESERVA_PILAS_TOPE];
+int num_pilas_reserva = 0;
+int max_pilas_reserva = RESERVA_PILAS_DEFECTO;
+
+/* Estadísticas de la reserva de pilas y del arranque de los procesos */
+unsigned int pilas_aciertos = 0;
+unsigned int pilas_fallos = 0;
+unsigned int num_arranques = 0;
+unsigned long long arranque_total_ns = 0;
+
+/* Caché de imágenes de los programas */
+imagen_prog tabla_imagenes[TABLA_IMAGENES];
+int max_imagenes_libres = CACHE_IMAGENES_DEFECTO;	/* Imágenes sin procesos que se conservan */
+int num_imagenes_libres = 0;
+int procs_con_imagen = 0;		/* Procesos vivos; al llegar a 0 se vacía */
+unsigned long long usos_imagenes = 0;	/* Reloj lógico para elegir a quién desalojar */
+
+/* Estadísticas de la caché de imágenes */
+unsigned int imagenes_aciertos = 0;
+unsigned int imagenes_fallos = 0;
+unsigned int imagenes_desalojos = 0;
+unsigned long long imagenes_carga_ns = 0;	/* Tiempo total en crear_imagen */
+
+/* Imágenes cargadas: liberar la última apaga el sistema, así que se
+	retiene mientras queden procesos con la carga pendiente */
+int imagenes_cargadas = 0;
+void *imagen_retenida = NULL;
+
+/* Carga diferida de los programas */
+int carga_diferida = 0;			/* Si está activa */
+int procs_pendientes = 0;		/* Procesos creados con la carga pendiente */
+
+/* Estadísticas de la creación y de la carga diferida */
+unsigned int num_creados = 0;
+unsigned long long creacion_total_ns = 0;	/* Dentro de crear_tareas */
+unsigned int cargas_diferidas = 0;
+unsigned long long carga_diferida_ns = 0;	/* Al elegirlos para ejecutar */
+
+/* Regla de expulsión al despertar elegida en el arranque */
+int regla_expulsion = EXPULSION_DEFECTO;
+
+/* Proceso al que debe pasar la UCP en la próxima interrupción software */
+BCP *proc_preferido = NULL;
+
+/* TICKs de reloj desde el arranque */
+unsigned long long ticks_sistema = 0;
 
-/* Variable global que representa la cola de procesos bloqueados */
-lista_BCPs lista_bloqueados = {NULL, NULL};
+/* Contabilidad del reparto de UCP */
+unsigned long long ticks_ocupados = 0;	/* TICKs con algún proceso en ejecución */
+unsigned int total_tickets = 0;		/* Tickets de los procesos vivos */
+
+/*
+ * Rueda jerárquica de temporización con los procesos dormidos. El nivel
+ * n agrupa los que despiertan a una distancia de entre RUEDA_RANURAS^n y
+ * RUEDA_RANURAS^(n+1) TICKs; cada ranura se ordena por llegada.
+ */
+lista_BCPs rueda[RUEDA_NIVELES][RUEDA_RANURAS];
+unsigned long long mapa_rueda[RUEDA_NIVELES];	/* Ranuras no vacías de cada nivel */
+unsigned long long rueda_ahora = 0;	/* Último TICK tratado por la rueda */
+unsigned long long rueda_orden = 0;	/* Contador de llegadas a la rueda */
+unsigned int num_dormidos = 0;		/* Procesos en la rueda */
+
+/* Coste del tratamiento de los procesos dormidos */
+unsigned int rueda_ticks = 0;		/* TICKs tratados */
+unsigned int rueda_visitas = 0;		/* Procesos movidos o despertados */
+unsigned int rueda_lineal = 0;		/* Procesos que habría recorrido una lista */
+
+/* Efecto de la holgura de los temporizadores */
+unsigned int despertares_agrupados = 0;	/* Despertares retrasados a un TICK compartido */
+unsigned int planificaciones_ahorradas = 0;	/* Pasadas del planificador evitadas */
 
 /* Lista de procesos en espera para crear un mutex */
-lista_BCPs lista_espera_mutex = {NULL, NULL};
+lista_BCPs lista_espera_mutex = {NULL, NULL, ENLACE_ESPERA};
+
+/* Variable global que representa la cola de mutex, reservada en el
+	arranque con num_mutex entradas */
+mutex *lista_mutex;
+int num_mutex = NUM_MUT;
+
+/* Índice de los nombres de mutex: cada cubeta es la primera entrada de
+	una cadena, o -1, y las entradas libres forman otra cadena */
+int *indice_mutex;
+unsigned int mascara_indice_mutex;	/* Cubetas menos 1; son potencia de 2 */
+int mutex_libres = -1;
 
-/* Variable global que representa la cola de mutex */
-mutex lista_mutex[NUM_MUT];
+/* Estadísticas de las búsquedas de nombres de mutex */
+unsigned int busquedas_mutex = 0;
+unsigned long long busqueda_mutex_ns = 0;
+
+/* Donación de rodaja a los dueños de mutex: los que tienen algo prestado
+	se eligen antes que los de la política */
+lista_BCPs lista_donados = {NULL, NULL, ENLACE_DONACION};
+int donacion_activa = 1;		/* Si está activa */
+unsigned int donaciones = 0;		/* Préstamos desde la última consulta */
+unsigned int ticks_prestados = 0;	/* TICKs prestados */
+unsigned int ticks_adelantados = 0;	/* TICKs prestados consumidos */
+unsigned int ticks_devueltos = 0;	/* TICKs prestados devueltos sin consumir */
 
 /*
  *
@@ -123,6 +512,79 @@ int obtener_id_pr();
 /* Rutina de bloqueo de proceso */
 int dormir(unsigned int seconds);
 
+/* Rutinas de tratamiento de prioridades */
+int fijar_prioridad(unsigned int prioridad);
+int obtener_prioridad();
+
+/* Rutinas de reparto proporcional de UCP */
+int fijar_tickets(unsigned int tickets);
+int obtener_reparto(unsigned int *real, unsigned int *objetivo);
+
+/* Rutinas de la clase de tiempo real */
+int fijar_tiempo_real(unsigned int periodo, unsigned int presupuesto, unsigned int plazo);
+int esperar_periodo();
+
+/* Rutina de consulta de la rodaja adaptativa */
+int obtener_rodaja(unsigned int *historia);
+
+/* Rutinas de cesión voluntaria de la UCP */
+int ceder_procesador();
+int ceder_a(int pid);
+
+/* Rutinas de los grupos con cuota de UCP */
+int crear_grupo(unsigned int cuota, unsigned int periodo);
+int obtener_uso_grupo(unsigned int num_grupo, unsigned int *consumo, unsigned int *estrangulamientos);
+
+/* Rutinas auxiliares de temporización y planificación */
+void timer();
+void process_unlock(BCPptr sleeping_process);
+
+/* Rutina de consulta del coste del tratamiento de los procesos dormidos */
+int obtener_coste_dormir(unsigned int *ticks, unsigned int *visitas, unsigned int *lineal);
+
+/* Rutinas de espera con resolución de TICK y temporizadores periódicos */
+int dormir_ticks(unsigned int ticks);
+int dormir_hasta(unsigned int tick);
+int crear_temporizador(unsigned int periodo);
+int esperar_temporizador(int num_temporizador);
+
+/* Rutinas de la holgura de los temporizadores */
+int fijar_holgura(unsigned int holgura);
+int obtener_agrupamiento(unsigned int *agrupados, unsigned int *ahorradas);
+
+/* Rutina de consulta del ahorro de la frecuencia de reloj dinámica */
+int obtener_ahorro_reloj(unsigned int *evitadas, unsigned int *tranquilos);
+
+/* Rutinas de la reserva de pilas */
+int fijar_reserva_pilas(unsigned int maximo);
+int obtener_reserva_pilas(unsigned int *aciertos, unsigned int *fallos, unsigned int *arranque_ns);
+
+/* Rutinas de la caché de imágenes */
+int fijar_cache_imagenes(unsigned int maximo);
+int obtener_cache_imagenes(unsigned int *aciertos, unsigned int *fallos, unsigned int *carga_ns);
+
+/* Rutina de creación de procesos por lotes */
+int sis_crear_procesos();
+
+/* Rutina de consulta de la liberación diferida de procesos */
+int obtener_recogida(unsigned int *fin_ns, unsigned int *recogida_ns);
+
+/* Rutina de espera a la terminación de un hijo */
+int esperar_proceso(int pid, int *estado);
+
+/* Rutinas de la carga diferida de los programas */
+int fijar_carga_diferida(unsigned int activa);
+int obtener_carga_diferida(unsigned int *creacion_ns, unsigned int *carga_ns);
+
+/* Rutina de consulta del índice de nombres de mutex */
+int obtener_nombres_mutex(unsigned int *busquedas, unsigned int *busqueda_ns);
+
+/* Rutinas de la donación de rodaja a los dueños de mutex */
+int fijar_donacion(unsigned int activa);
+int obtener_donacion(unsigned int *prestados, unsigned int *adelantados, unsigned int *devueltos, int *rodaja, int *pendiente);
+void round_robin();
+void robin_process_change();
+
 /* Rutinas de tratamiento de mutex */
 int crear_mutex(char *nombre, int tipo);
 int abrir_mutex(char *nombre);
@@ -142,7 +604,38 @@ servicio tabla_servicios[NSERVICIOS]={	{sis_crear_proceso},
 					{abrir_mutex},
 					{lock},
 					{unlock},
-					{cerrar_mutex}};
+					{cerrar_mutex},
+					{fijar_prioridad},
+					{obtener_prioridad},
+					{fijar_tickets},
+					{obtener_reparto},
+					{fijar_tiempo_real},
+					{esperar_periodo},
+					{obtener_rodaja},
+					{ceder_procesador},
+					{ceder_a},
+					{crear_grupo},
+					{obtener_uso_grupo},
+					{obtener_coste_dormir},
+					{dormir_ticks},
+					{dormir_hasta},
+					{crear_temporizador},
+					{esperar_temporizador},
+					{fijar_holgura},
+					{obtener_agrupamiento},
+					{obtener_ahorro_reloj},
+					{fijar_reserva_pilas},
+					{obtener_reserva_pilas},
+					{fijar_cache_imagenes},
+					{obtener_cache_imagenes},
+					{sis_crear_procesos},
+					{obtener_recogida},
+					{esperar_proceso},
+					{fijar_carga_diferida},
+					{obtener_carga_diferida},
+					{obtener_nombres_mutex},
+					{fijar_donacion},
+					{obtener_donacion}};
 
 #endif /* _KERNEL_H */
 
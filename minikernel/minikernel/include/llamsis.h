@@ -19,7 +19,7 @@
 #define _LLAMSIS_H
 
 /* Numero de llamadas disponibles */
-#define NSERVICIOS 10 //9
+#define NSERVICIOS 41
 
 #define CREAR_PROCESO 0
 #define TERMINAR_PROCESO 1
@@ -31,6 +31,37 @@
 #define LOCK 7
 #define UNLOCK 8
 #define CERRAR_MUTEX 9
+#define FIJAR_PRIORIDAD 10
+#define OBTENER_PRIORIDAD 11
+#define FIJAR_TICKETS 12
+#define OBTENER_REPARTO 13
+#define FIJAR_TIEMPO_REAL 14
+#define ESPERAR_PERIODO 15
+#define OBTENER_RODAJA 16
+#define CEDER_PROCESADOR 17
+#define CEDER_A 18
+#define CREAR_GRUPO 19
+#define OBTENER_USO_GRUPO 20
+#define OBTENER_COSTE_DORMIR 21
+#define DORMIR_TICKS 22
+#define DORMIR_HASTA 23
+#define CREAR_TEMPORIZADOR 24
+#define ESPERAR_TEMPORIZADOR 25
+#define FIJAR_HOLGURA 26
+#define OBTENER_AGRUPAMIENTO 27
+#define OBTENER_AHORRO_RELOJ 28
+#define FIJAR_RESERVA_PILAS 29
+#define OBTENER_RESERVA_PILAS 30
+#define FIJAR_CACHE_IMAGENES 31
+#define OBTENER_CACHE_IMAGENES 32
+#define CREAR_PROCESOS 33
+#define OBTENER_RECOGIDA 34
+#define ESPERAR_PROCESO 35
+#define FIJAR_CARGA_DIFERIDA 36
+#define OBTENER_CARGA_DIFERIDA 37
+#define OBTENER_NOMBRES_MUTEX 38
+#define FIJAR_DONACION 39
+#define OBTENER_DONACION 40
 
 #endif /* _LLAMSIS_H */
 
@@ -18,349 +18,3038 @@
 /*
  *
  * Funciones relacionadas con la tabla de procesos:
- *	iniciar_tabla_proc buscar_BCP_libre
+ *	iniciar_tabla_proc BCP_ranura crecer_tabla_proc buscar_BCP_libre
+ *	liberar_BCP buscar_BCP
  *
  */
 
+static int crecer_tabla_proc();
+static void cerrar_descriptor(BCP *proc, int pos);
+static int recoger_terminados(int max);
+static int cargar_tarea(BCP *proc);
+static void consumir_donacion(BCP *dueno);
+static void donados_poner(BCP *proc);
+static void donados_quitar(BCP *proc);
+
 /*
- * Funci�n que inicia la tabla de procesos
+ * Funci�n que inicia la tabla de procesos. El límite se lee de la variable
+ * de entorno MINIKERNEL_MAX_PROC y se redondea a bloques completos; las
+ * estructuras de los planificadores indexadas por entrada se dimensionan
+ * con él.
  */
 static void iniciar_tabla_proc(){
+	char *limite;
+
+	limite=getenv(MAX_PROC_ENV);
+	if (limite!=NULL)
+		limite_procs=atoi(limite);
+	if (limite_procs<MAX_PROC)
+		limite_procs=MAX_PROC;
+	if (limite_procs>MAX_PROC_TOPE)
+		limite_procs=MAX_PROC_TOPE;
+	limite_procs=(limite_procs+BLOQUE_PROCS-1)/BLOQUE_PROCS*BLOQUE_PROCS;
+
+	cfs_heap=malloc(limite_procs*sizeof(BCP *));
+	lottery_tree=calloc(limite_procs+1, sizeof(int));
+	if (cfs_heap==NULL || lottery_tree==NULL || crecer_tabla_proc()<0)
+		panico("no hay memoria para la tabla de procesos");
+}
+
+/*
+ * Devuelve el BCP de una entrada reservada de la tabla
+ */
+static inline BCP * BCP_ranura(int ranura){
+	return &tabla_procs[ranura/BLOQUE_PROCS][ranura%BLOQUE_PROCS];
+}
+
+/*
+ * Añade un bloque de entradas libres a la tabla si no se ha alcanzado el
+ * límite. Los bloques ya reservados no se mueven, así que los punteros a
+ * BCP siguen siendo válidos.
+ */
+static int crecer_tabla_proc(){
+	int bloque=capacidad_procs/BLOQUE_PROCS;
+	BCP *nuevo;
 	int i;
 
-	for (i=0; i<MAX_PROC; i++)
-		tabla_procs[i].estado=NO_USADA;
+	if (capacidad_procs+BLOQUE_PROCS>limite_procs)
+		return -1;
+	nuevo=calloc(BLOQUE_PROCS, sizeof(BCP));	/* todas NO_USADA */
+	if (nuevo==NULL)
+		return -1;
+	for (i=0; i<BLOQUE_PROCS; i++)
+		nuevo[i].ranura=capacidad_procs+i;
+	tabla_procs[bloque]=nuevo;
+	mapa_procs_libres[bloque]=~0ULL;
+	resumen_procs_libres[bloque/64]|=1ULL << (bloque%64);
+	capacidad_procs+=BLOQUE_PROCS;
+	return 0;
 }
 
 /*
- * Funci�n que busca una entrada libre en la tabla de procesos
+ * Funci�n que busca una entrada libre en la tabla de procesos y la
+ * reserva. Devuelve la de menor índice consultando el resumen y una sola
+ * palabra del mapa; si no queda ninguna, hace crecer la tabla.
  */
 static int buscar_BCP_libre(){
-	int i;
+	int i, bloque=-1, bit;
 
-	for (i=0; i<MAX_PROC; i++)
-		if (tabla_procs[i].estado==NO_USADA)
-			return i;
-	return -1;
+	for (i=0; i<NUM_BLOQUES_PROCS/64 && bloque<0; i++)
+		if (resumen_procs_libres[i])
+			bloque=i*64 + __builtin_ctzll(resumen_procs_libres[i]);
+	if (bloque<0) {
+		if (crecer_tabla_proc()<0)
+			return -1;
+		bloque=capacidad_procs/BLOQUE_PROCS - 1;
+	}
+
+	bit=__builtin_ctzll(mapa_procs_libres[bloque]);
+	mapa_procs_libres[bloque]&=~(1ULL << bit);
+	if (mapa_procs_libres[bloque]==0)
+		resumen_procs_libres[bloque/64]&=~(1ULL << (bloque%64));
+	return bloque*BLOQUE_PROCS + bit;
+}
+
+/*
+ * Devuelve una entrada al mapa de libres. La siguiente ocupación tendrá
+ * otra generación y, por tanto, otro identificador.
+ */
+static void liberar_BCP(int ranura){
+	BCP *proc=BCP_ranura(ranura);
+	int bloque=ranura/BLOQUE_PROCS;
+
+	proc->estado=NO_USADA;
+	proc->generacion=(proc->generacion+1) % NUM_GENERACIONES;
+	mapa_procs_libres[bloque]|=1ULL << (ranura%BLOQUE_PROCS);
+	resumen_procs_libres[bloque/64]|=1ULL << (bloque%64);
+}
+
+/*
+ * Funci�n que busca el BCP de un proceso existente por su identificador.
+ * El identificador incluye la generación de la entrada, de modo que el de
+ * un proceso terminado no encuentra al que reutiliza su entrada.
+ */
+static BCP * buscar_BCP(int pid){
+	BCP *proc;
+
+	if (pid<0 || pid%MAX_PROC_TOPE>=capacidad_procs)
+		return NULL;
+	proc=BCP_ranura(pid%MAX_PROC_TOPE);
+	if (proc->estado==NO_USADA || proc->id!=pid)
+		return NULL;
+	return proc;
 }
 
 /*
  *
  * Funciones que facilitan el manejo de las listas de BCPs
- *	insertar_ultimo eliminar_primero eliminar_elem
+ *	iniciar_lista siguiente_BCP anterior_BCP comprobar_lista
+ *	insertar_ultimo insertar_primero insertar_detras eliminar_primero
+ *	eliminar_elem concatenar_listas
  *
  * NOTA: PRIMERO SE DEBE LLAMAR A eliminar Y LUEGO A insertar
+ *
+ * Todas las operaciones son de coste constante salvo la comprobación,
+ * que solo se compila con -DDEPURAR_LISTAS.
  */
 
+/* Enlace del BCP que corresponde al tipo de la lista */
+#define ENLACE(lista, proc) ((proc)->enlaces[(lista)->enlace])
+
 /*
- * Inserta un BCP al final de la lista.
+ * Deja vacía una lista cuyos BCPs usarán el enlace indicado
  */
-static void insertar_ultimo(lista_BCPs *lista, BCP * proc){
-	if (lista->primero==NULL)
-		lista->primero= proc;
+static void iniciar_lista(lista_BCPs *lista, int enlace){
+	lista->primero=NULL;
+	lista->ultimo=NULL;
+	lista->enlace=enlace;
+}
+
+static inline BCP * siguiente_BCP(lista_BCPs *lista, BCP *proc){
+	return ENLACE(lista, proc).siguiente;
+}
+
+static inline BCP * anterior_BCP(lista_BCPs *lista, BCP *proc){
+	return ENLACE(lista, proc).anterior;
+}
+
+/*
+ * Recorre la lista comprobando que los enlaces en ambos sentidos son
+ * coherentes, que los extremos son correctos, que no hay ciclos y, si se
+ * indica, que el BCP pertenece a ella. Para el sistema si no es así.
+ */
+#ifdef DEPURAR_LISTAS
+static void comprobar_lista(lista_BCPs *lista, BCP *miembro){
+	BCP *proc, *ant=NULL;
+	int num=0, encontrado=(miembro==NULL);
+
+	for (proc=lista->primero; proc; ant=proc, proc=siguiente_BCP(lista, proc)) {
+		if (anterior_BCP(lista, proc)!=ant || ++num>capacidad_procs)
+			panico("lista de BCPs corrupta");
+		if (proc==miembro)
+			encontrado=1;
+	}
+	if (lista->ultimo!=ant || !encontrado)
+		panico("lista de BCPs corrupta");
+}
+#else
+#define comprobar_lista(lista, miembro)
+#endif
+
+/*
+ * Inserta un BCP detrás de otro que ya está en la lista, o al principio
+ * si no se indica ninguno.
+ */
+static void insertar_detras(lista_BCPs *lista, BCP *ant, BCP * proc){
+	BCP *sig=(ant==NULL) ? lista->primero : siguiente_BCP(lista, ant);
+
+	ENLACE(lista, proc).anterior=ant;
+	ENLACE(lista, proc).siguiente=sig;
+	if (ant==NULL)
+		lista->primero=proc;
 	else
-		lista->ultimo->siguiente=proc;
-	lista->ultimo= proc;
-	proc->siguiente=NULL;
+		ENLACE(lista, ant).siguiente=proc;
+	if (sig==NULL)
+		lista->ultimo=proc;
+	else
+		ENLACE(lista, sig).anterior=proc;
+	comprobar_lista(lista, proc);
 }
 
 /*
- * Elimina el primer BCP de la lista.
+ * Inserta un BCP al final de la lista.
  */
-static void eliminar_primero(lista_BCPs *lista){
+static void insertar_ultimo(lista_BCPs *lista, BCP * proc){
+	insertar_detras(lista, lista->ultimo, proc);
+}
 
-	if (lista->ultimo==lista->primero)
-		lista->ultimo=NULL;
-	lista->primero=lista->primero->siguiente;
+/*
+ * Inserta un BCP al principio de la lista.
+ */
+static void insertar_primero(lista_BCPs *lista, BCP * proc){
+	insertar_detras(lista, NULL, proc);
 }
 
 /*
  * Elimina un determinado BCP de la lista.
  */
 static void eliminar_elem(lista_BCPs *lista, BCP * proc){
-	BCP *paux=lista->primero;
+	BCP *ant=anterior_BCP(lista, proc);
+	BCP *sig=siguiente_BCP(lista, proc);
+
+	comprobar_lista(lista, proc);
+	if (ant==NULL)
+		lista->primero=sig;
+	else
+		ENLACE(lista, ant).siguiente=sig;
+	if (sig==NULL)
+		lista->ultimo=ant;
+	else
+		ENLACE(lista, sig).anterior=ant;
+	ENLACE(lista, proc).siguiente=NULL;
+	ENLACE(lista, proc).anterior=NULL;
+}
 
-	if (paux==proc)
-		eliminar_primero(lista);
+/*
+ * Elimina el primer BCP de la lista.
+ */
+static void eliminar_primero(lista_BCPs *lista){
+	eliminar_elem(lista, lista->primero);
+}
+
+/*
+ * Añade al final de una lista todos los BCPs de otra del mismo tipo, que
+ * queda vacía.
+ */
+static void concatenar_listas(lista_BCPs *destino, lista_BCPs *origen){
+	if (origen->primero==NULL)
+		return;
+	if (destino->primero==NULL)
+		destino->primero=origen->primero;
 	else {
-		for ( ; ((paux) && (paux->siguiente!=proc));
-			paux=paux->siguiente);
-		if (paux) {
-			if (lista->ultimo==paux->siguiente)
-				lista->ultimo=paux;
-			paux->siguiente=paux->siguiente->siguiente;
-		}
+		ENLACE(destino, destino->ultimo).siguiente=origen->primero;
+		ENLACE(destino, origen->primero).anterior=destino->ultimo;
 	}
+	destino->ultimo=origen->ultimo;
+	origen->primero=origen->ultimo=NULL;
+	comprobar_lista(destino, NULL);
 }
 
 /*
  *
- * Funciones relacionadas con la planificacion
- *	espera_int planificador
+ * Funciones de la rueda jerárquica de temporización
+ *	iniciar_rueda rueda_insertar_orden rueda_insertar rueda_holgura
+ *	rueda_dormir rueda_cascada rueda_cercana rueda_tranquila rueda_saltar
+ *
  */
 
 /*
- * Espera a que se produzca una interrupcion
+ * Las ranuras usan su propio enlace del BCP
  */
-static void espera_int(){
-	int nivel;
+static void iniciar_rueda(){
+	int nivel, ranura;
 
-	/* Por limpieza en la ejecución se comenta esta parte
-	printk("-> NO HAY LISTOS. ESPERA INT\n"); */
+	for (nivel=0; nivel<RUEDA_NIVELES; nivel++)
+		for (ranura=0; ranura<RUEDA_RANURAS; ranura++)
+			iniciar_lista(&rueda[nivel][ranura], ENLACE_RUEDA);
+}
 
-	/* Baja al m�nimo el nivel de interrupci�n mientras espera */
-	nivel=fijar_nivel_int(NIVEL_1);
-	halt();
-	fijar_nivel_int(nivel);
+/*
+ * Inserta el BCP en la ranura respetando el orden de llegada a la rueda.
+ * Los que llegan directamente van siempre al final; solo los que bajan
+ * de nivel pueden tener que colocarse antes.
+ */
+static void rueda_insertar_orden(lista_BCPs *ranura, BCP *proc){
+	BCP *paux=ranura->ultimo;
+
+	while (paux && proc->orden_sueno < paux->orden_sueno)
+		paux=anterior_BCP(ranura, paux);
+	insertar_detras(ranura, paux, proc);
 }
 
 /*
- * Funci�n de planificacion que implementa un algoritmo FIFO.
+ * Coloca el BCP en el nivel y la ranura que corresponden a la distancia
+ * entre su TICK de despertar y el actual de la rueda
  */
-static BCP * planificador(){
-	while (lista_listos.primero==NULL)
-		espera_int();		/* No hay nada que hacer */
-	return lista_listos.primero;
+static void rueda_insertar(BCP *proc){
+	unsigned long long delta=proc->despertar - rueda_ahora;
+	unsigned long long tick=proc->despertar;
+	int nivel, ranura;
+
+	/* Más allá del alcance de la rueda se recoloca al bajar de nivel */
+	if (delta > RUEDA_MAX_DELTA) {
+		delta=RUEDA_MAX_DELTA;
+		tick=rueda_ahora + RUEDA_MAX_DELTA;
+	}
+	for (nivel=0; nivel < RUEDA_NIVELES-1 &&
+		delta >= (1ULL << (RUEDA_BITS*(nivel+1))); nivel++);
+	ranura=(tick >> (RUEDA_BITS*nivel)) & RUEDA_MASCARA;
+	rueda_insertar_orden(&rueda[nivel][ranura], proc);
+	mapa_rueda[nivel]|=1ULL << ranura;
 }
 
 /*
- *
- * Funcion auxiliar que termina proceso actual liberando sus recursos.
- * Usada por llamada terminar_proceso y por rutinas que tratan excepciones
- *
+ * Elige el TICK en que despierta un proceso que puede hacerlo en cualquiera
+ * de [despertar, despertar+holgura]. Si en esa ventana ya despierta otro
+ * proceso, se une a él; si no, se redondea a un múltiplo de la mayor
+ * potencia de dos que cabe en la ventana, de modo que las ventanas que se
+ * solapan tienden a coincidir en el mismo TICK.
  */
-static void liberar_proceso(){
-	BCP * p_proc_anterior;
+static unsigned long long rueda_holgura(unsigned long long despertar,
+	unsigned int holgura){
+	unsigned long long tick, ultimo=despertar + holgura;
+	unsigned long long granularidad;
+
+	/* Solo en el nivel 0 cada ranura corresponde a un único TICK */
+	for (tick=despertar; tick<=ultimo && tick - rueda_ahora < RUEDA_RANURAS; tick++)
+		if (rueda[0][tick & RUEDA_MASCARA].primero!=NULL)
+			return tick;
+
+	granularidad=1ULL << (63 - __builtin_clzll(holgura + 1ULL));
+	return ultimo - ultimo % granularidad;
+}
 
-	liberar_imagen(p_proc_actual->info_mem); /* liberar mapa */
+/*
+ * Mete en la rueda un proceso que debe despertar en el TICK indicado, o
+ * en el siguiente si ese ya ha pasado, más la holgura que admita
+ */
+static void rueda_dormir(BCP *proc, unsigned long long despertar){
+	if (despertar <= rueda_ahora)
+		despertar=rueda_ahora + 1;
+	proc->despertar_pedido=despertar;
+	if (proc->holgura)
+		despertar=rueda_holgura(despertar, proc->holgura);
+	proc->despertar=despertar;
+	proc->orden_sueno=rueda_orden++;
+	num_dormidos++;
+	rueda_insertar(proc);
+}
 
-	/* Al terminar el proceso se cierran todos los mutex que utilizaban */
-	for(int i = 0; i < NUM_MUT_PROC; i++){
-		if(p_proc_actual->descriptor[i] != 0) cerrar_mutex(p_proc_actual->descriptor[i]);
+/*
+ * Baja al nivel inferior los procesos de la ranura del nivel indicado
+ * que corresponde al TICK actual. Devuelve el índice de esa ranura.
+ */
+static int rueda_cascada(int nivel){
+	int indice=(rueda_ahora >> (RUEDA_BITS*nivel)) & RUEDA_MASCARA;
+	lista_BCPs *ranura=&rueda[nivel][indice];
+	BCP *proc;
+
+	mapa_rueda[nivel]&=~(1ULL << indice);
+	while ((proc=ranura->primero)!=NULL) {
+		eliminar_primero(ranura);
+		rueda_visitas++;
+		rueda_insertar(proc);
 	}
+	return indice;
+}
+
+/*
+ * Devuelve 1 si algún proceso puede despertar en los próximos
+ * RUEDA_RANURAS TICKs, aproximadamente: los del nivel 0 y los del
+ * siguiente bloque de cada nivel que empiece justo a continuación
+ */
+static int rueda_cercana(){
+	unsigned long long bloque;
+	int nivel;
 
-	p_proc_actual->estado=TERMINADO;
-	eliminar_primero(&lista_listos); /* proc. fuera de listos */
+	if (mapa_rueda[0])
+		return 1;
+	for (nivel=1; nivel<RUEDA_NIVELES; nivel++) {
+		bloque=(rueda_ahora >> (RUEDA_BITS*nivel)) + 1;
+		if (mapa_rueda[nivel] & (1ULL << (bloque & RUEDA_MASCARA)))
+			return 1;
+		/* El siguiente bloque del nivel superior aún está lejos */
+		if (bloque & RUEDA_MASCARA)
+			return 0;
+	}
+	return 0;
+}
 
-	/* Realizar cambio de contexto */
-	p_proc_anterior=p_proc_actual;
-	p_proc_actual=planificador();
+/*
+ * Devuelve 1 si la rueda no tiene nada que hacer hasta el TICK actual:
+ * no hay que bajar ninguna ranura de nivel ni despertar a nadie
+ */
+static int rueda_tranquila(){
+	unsigned long long desde=(rueda_ahora + 1) & RUEDA_MASCARA;
+	unsigned long long hasta=ticks_sistema & RUEDA_MASCARA;
 
-	printk("-> C.CONTEXTO POR FIN: de %d a %d\n",
-			p_proc_anterior->id, p_proc_actual->id);
+	if ((rueda_ahora >> RUEDA_BITS) != (ticks_sistema >> RUEDA_BITS))
+		return 0;
+	return (mapa_rueda[0] & ((2ULL << hasta) - 1) & ~((1ULL << desde) - 1))==0;
+}
 
-	liberar_pila(p_proc_anterior->pila);
-	cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
-        return; /* no deber�a llegar aqui */
+/*
+ * Avanza la rueda hasta el TICK actual sin recorrerla; solo es válido si
+ * rueda_tranquila lo permite
+ */
+static void rueda_saltar(){
+	rueda_ticks+=ticks_sistema - rueda_ahora;
+	rueda_lineal+=(ticks_sistema - rueda_ahora)*num_dormidos;
+	rueda_ahora=ticks_sistema;
 }
 
 /*
  *
- * Funciones relacionadas con el tratamiento de interrupciones
- *	excepciones: exc_arit exc_mem
- *	interrupciones de reloj: int_reloj
- *	interrupciones del terminal: int_terminal
- *	llamadas al sistemas: llam_sis
- *	interrupciones SW: int_sw
+ * Funciones relacionadas con la planificacion
+ *	espera_int planificador planificar_hacia elegir_planificador
+ *	elegir_expulsion expulsion_despertar
+ *	grupo_aparcar grupo_entrar grupo_salir grupo_estrangular grupo_tick grupo_release
+ *	elegir_reloj reloj_ajustar tick_tranquilo
+ *	ready_new ready_insert ready_remove ready_block ready_wakeup
+ *	ready_expire ready_tick ready_preempt
+ *
+ * Cada política implementa la tabla de operaciones sched_ops y se elige
+ * en el arranque con la variable de entorno PLANIF_ENV:
+ *	fifo: una cola sin expulsión (fifo_*)
+ *	rr: una cola con rodaja fija de TICKS_POR_RODAJA (rr_*)
+ *	adaptive: una cola con rodaja adaptada a cada proceso (adapt_*)
+ *	mlfq: prioridades estáticas y colas multinivel (mlfq_*)
+ *	cfs: reparto por tiempo virtual de ejecución (cfs_*)
+ *	stride: reparto proporcional a los tickets por stride (stride_*)
+ *	lottery: reparto proporcional a los tickets por sorteo (lottery_*)
  *
+ * En todas el proceso en ejecución permanece en la estructura de listos.
  */
 
 /*
- * Tratamiento de excepciones aritmeticas
+ * Planificación FIFO y round robin, que comparten la cola cola_rr
  */
-static void exc_arit(){
 
-	if (!viene_de_modo_usuario())
-		panico("excepcion aritmetica cuando estaba dentro del kernel");
+static void fifo_init(BCP *proc){
+	proc->robin_seconds=TICKS_POR_RODAJA;
+}
+
+static void fifo_enqueue(BCP *proc){
+	insertar_ultimo(&cola_rr, proc);
+}
 
+static void fifo_dequeue(BCP *proc){
+	eliminar_elem(&cola_rr, proc);
+}
 
-	printk("-> EXCEPCION ARITMETICA EN PROC %d\n", p_proc_actual->id);
-	liberar_proceso();
+static BCP * fifo_pick_next(){
+	return cola_rr.primero;
+}
 
-        return; /* no deber�a llegar aqui */
+/*
+ * En FIFO el proceso solo deja la UCP cuando se bloquea, termina o cede
+ */
+static int fifo_tick(BCP *proc){
+	return 0;
+}
+
+static void fifo_yield(BCP *proc){
+	eliminar_elem(&cola_rr, proc);
+	insertar_ultimo(&cola_rr, proc);
 }
 
 /*
- * Tratamiento de excepciones en el acceso a memoria
+ * En round robin el proceso es expulsado al agotar la rodaja
  */
-static void exc_mem(){
+static int rr_tick(BCP *proc){
+	if (--proc->robin_seconds > 0)
+		return 0;
+	printk("Ronda del proceso terminada, llamando a interrupción de software.\n");
+	return 1;
+}
 
-	if (!viene_de_modo_usuario())
-		panico("excepcion de memoria cuando estaba dentro del kernel");
+/*
+ * Al volver a la cola, tanto tras ceder la UCP como al despertar, el
+ * proceso recibe una rodaja completa
+ */
+static void rr_yield(BCP *proc){
+	fifo_yield(proc);
+	proc->robin_seconds=TICKS_POR_RODAJA;
+}
 
+static void rr_wakeup(BCP *proc){
+	proc->robin_seconds=TICKS_POR_RODAJA;
+	insertar_ultimo(&cola_rr, proc);
+}
 
-	printk("-> EXCEPCION DE MEMORIA EN PROC %d\n", p_proc_actual->id);
-	liberar_proceso();
+/*
+ * Round robin adaptativo sobre cola_rr. Cada proceso tiene su propia
+ * rodaja: se duplica cada vez que la agota, lo que reduce los cambios de
+ * contexto de los procesos intensivos en UCP, y se reduce a la mitad
+ * cuando se bloquea antes de agotarla, en cuyo caso al despertar se
+ * coloca al principio de la cola para atenderlo con urgencia.
+ */
 
-        return; /* no deber�a llegar aqui */
+/*
+ * Fija la rodaja del proceso y la anota en su historial
+ */
+static void adapt_set_quantum(BCP *proc, unsigned int quantum){
+	proc->quantum=quantum;
+	proc->robin_seconds=quantum;
+	proc->quantum_hist[proc->quantum_hist_pos]=quantum;
+	proc->quantum_hist_pos=(proc->quantum_hist_pos + 1) % QUANTUM_HIST;
+}
+
+static void adapt_init(BCP *proc){
+	memset(proc->quantum_hist, 0, sizeof(proc->quantum_hist));
+	proc->quantum_hist_pos=0;
+	adapt_set_quantum(proc, TICKS_POR_RODAJA);
 }
 
 /*
- * Tratamiento de interrupciones de terminal
+ * Si ha agotado la rodaja la siguiente es el doble; si deja la UCP por
+ * otro motivo conserva lo que le queda
  */
-static void int_terminal(){
-	char car;
+static void adapt_yield(BCP *proc){
+	fifo_yield(proc);
+	if (proc->robin_seconds > 0)
+		return;
+	if (proc->quantum*2 <= RODAJA_MAX)
+		adapt_set_quantum(proc, proc->quantum*2);
+	else
+		adapt_set_quantum(proc, RODAJA_MAX);
+}
 
-	car = leer_puerto(DIR_TERMINAL);
-	printk("-> TRATANDO INT. DE TERMINAL %c\n", car);
+static void adapt_wakeup(BCP *proc){
+	if (proc->robin_seconds <= 0) {
+		adapt_set_quantum(proc, proc->quantum);
+		insertar_ultimo(&cola_rr, proc);
+		return;
+	}
+	if (proc->quantum/2 >= RODAJA_MIN)
+		adapt_set_quantum(proc, proc->quantum/2);
+	else
+		adapt_set_quantum(proc, RODAJA_MIN);
+	insertar_primero(&cola_rr, proc);
+}
 
-        return;
+/*
+ * Planificación MLFQ. Hay una cola de listos por cada par (prioridad
+ * estática, nivel MLFQ), ordenadas de forma que toda la prioridad p
+ * precede a la p+1 y, dentro de una prioridad, la MLFQ ordena por niveles.
+ * mapa_listos tiene un bit por cola no vacía, por lo que elegir proceso
+ * es un find-first-set.
+ */
+
+/*
+ * Rodaja asignada a un nivel de la MLFQ: los niveles inferiores, donde
+ * acaban los procesos intensivos en UCP, tienen rodajas más largas
+ */
+static int mlfq_quantum(int level){
+	return TICKS_POR_RODAJA << level;
+}
+
+/*
+ * Cola de listos que corresponde a un proceso según su prioridad y nivel
+ */
+static int mlfq_index(BCP *proc){
+	return proc->priority*MLFQ_LEVELS + proc->level;
 }
 
+/*
+ * Inserta un proceso al final de su cola de listos
+ */
+static void mlfq_insert(BCP *proc){
+	int i=mlfq_index(proc);
 
-void round_robin(){
-	if(p_proc_actual->estado == LISTO) p_proc_actual->robin_seconds--;
+	insertar_ultimo(&lista_listos[i], proc);
+	mapa_listos |= 1U << i;
+}
 
-		if(p_proc_actual->robin_seconds <= 0){
-			printk("Ronda del proceso terminada, llamando a interrupción de software.\n");
+/*
+ * Elimina un proceso de su cola de listos. Debe llamarse antes de
+ * modificar el nivel o la prioridad del proceso.
+ */
+static void mlfq_remove(BCP *proc){
+	int i=mlfq_index(proc);
 
-			/* Como se indica en el manual del minikernel, las interrupciones de Software se
-				realizan para el tratamiento de cambios de contexto involuntarios */
-			activar_int_SW();
+	eliminar_elem(&lista_listos[i], proc);
+	if (lista_listos[i].primero==NULL)
+		mapa_listos &= ~(1U << i);
+}
+
+/*
+ * Primer proceso de la cola no vacía más prioritaria o NULL
+ */
+static BCP * mlfq_first(){
+	if (mapa_listos==0)
+		return NULL;
+	return lista_listos[__builtin_ffs(mapa_listos) - 1].primero;
+}
+
+/*
+ * Devuelve 1 si hay algún proceso listo en una cola más prioritaria
+ * que la del proceso indicado
+ */
+static int mlfq_higher_ready(BCP *proc){
+	return (mapa_listos & ((1U << mlfq_index(proc)) - 1)) != 0;
+}
+
+/*
+ * Un proceso que se bloqueó sin agotar su rodaja se considera interactivo
+ * y sube un nivel. En cualquier caso recibe una rodaja nueva de su nivel.
+ * Se aplica al despertar, antes de volver a la cola de listos.
+ */
+static void mlfq_promote(BCP *proc){
+	if (proc->robin_seconds > 0 && proc->level > 0)
+		proc->level--;
+	proc->robin_seconds = mlfq_quantum(proc->level);
+}
+
+/*
+ * Si ha agotado la rodaja baja un nivel y recibe la rodaja del nuevo
+ * nivel; si ha sido expulsado por un proceso más prioritario conserva lo
+ * que le queda. El proceso ya debe estar fuera de la cola de listos.
+ */
+static void mlfq_demote(BCP *proc){
+	if (proc->robin_seconds > 0)
+		return;
+	if (proc->level < MLFQ_LEVELS - 1)
+		proc->level++;
+	proc->robin_seconds = mlfq_quantum(proc->level);
+}
+
+/*
+ * Cada MLFQ_BOOST_TICKS sube todos los procesos al nivel 0 para que los
+ * procesos de los niveles bajos no sufran inanición
+ */
+static void mlfq_boost(){
+	int i, prio;
+	lista_BCPs *top, *cola;
+	BCP *proc;
+
+	if (++ticks_since_boost < MLFQ_BOOST_TICKS)
+		return;
+	ticks_since_boost = 0;
+
+	/* En cada prioridad se concatenan las colas inferiores al final de
+		la del nivel 0; la prioridad estática no cambia */
+	for (prio=0; prio<NUM_PRIORIDADES; prio++) {
+		top = &lista_listos[prio*MLFQ_LEVELS];
+		for (i=1; i<MLFQ_LEVELS; i++) {
+			cola = &lista_listos[prio*MLFQ_LEVELS + i];
+			if (cola->primero==NULL)
+				continue;
+			concatenar_listas(top, cola);
+			mapa_listos &= ~(1U << (prio*MLFQ_LEVELS + i));
+			mapa_listos |= 1U << (prio*MLFQ_LEVELS);
 		}
+	}
+
+	/* Incluye también a los bloqueados, que volverán en el nivel 0 */
+	for (i=0; i<capacidad_procs; i++) {
+		proc=BCP_ranura(i);
+		if (proc->estado==NO_USADA)
+			continue;
+		proc->level=0;
+		if (proc->robin_seconds > mlfq_quantum(0))
+			proc->robin_seconds=mlfq_quantum(0);
+	}
+}
+
+static void mlfq_init(BCP *proc){
+	/* Todo proceso nuevo entra en el nivel más prioritario */
+	proc->level=0;
+	proc->robin_seconds=mlfq_quantum(proc->level);
+}
+
+/*
+ * Tratamiento del tick para el proceso en ejecución: devuelve 1 si debe
+ * ser expulsado porque ha agotado su rodaja o hay otro más prioritario
+ */
+static int mlfq_tick(BCP *proc){
+	mlfq_boost();
+	proc->robin_seconds--;
+	if (proc->robin_seconds <= 0) {
+		printk("Ronda del proceso terminada, llamando a interrupción de software.\n");
+		return 1;
+	}
+	return mlfq_higher_ready(proc);
 }
 
+static void mlfq_yield(BCP *proc){
+	mlfq_remove(proc);
+	mlfq_demote(proc);
+	mlfq_insert(proc);
+}
 
+static void mlfq_wakeup(BCP *proc){
+	mlfq_promote(proc);
+	mlfq_insert(proc);
+}
 
 /*
- * Tratamiento de interrupciones de reloj
+ * Planificación CFS. Cada proceso acumula un tiempo virtual de ejecución
+ * inversamente proporcional a su peso, que se deriva de su prioridad, y
+ * siempre se elige el de menor vruntime. Los listos se guardan en un
+ * montículo mínimo y cada BCP recuerda su posición para poder eliminarlo
+ * en O(log n).
  */
-static void int_reloj(){
 
-	/* Para mayor limpieza en la ejecución del código se prescinde de este print
-	printk("-> TRATANDO INT. DE RELOJ\n");	*/
-	timer();
-	round_robin();
+/* Peso de cada prioridad: cada nivel da un 25% más de UCP que el siguiente */
+static const unsigned int cfs_weight[NUM_PRIORIDADES]={
+	2500, 2000, 1600, 1280, 1024, 820, 655, 524 };
 
-        return;
+/*
+ * Tiempo virtual que supone ejecutar n TICKs para un proceso
+ */
+static unsigned long long cfs_delta(BCP *proc, int ticks){
+	return (unsigned long long)ticks * CFS_PESO_BASE * CFS_PESO_BASE /
+		cfs_weight[proc->priority];
+}
+
+static void cfs_swap(int i, int j){
+	BCP *aux=cfs_heap[i];
+
+	cfs_heap[i]=cfs_heap[j];
+	cfs_heap[j]=aux;
+	cfs_heap[i]->heap_pos=i;
+	cfs_heap[j]->heap_pos=j;
+}
+
+static void cfs_sift_up(int i){
+	while (i>0 && cfs_heap[i]->vruntime < cfs_heap[(i-1)/2]->vruntime) {
+		cfs_swap(i, (i-1)/2);
+		i=(i-1)/2;
+	}
+}
+
+static void cfs_sift_down(int i){
+	int menor;
+
+	for (;;) {
+		menor=i;
+		if (2*i+1<cfs_heap_size &&
+		    cfs_heap[2*i+1]->vruntime < cfs_heap[menor]->vruntime)
+			menor=2*i+1;
+		if (2*i+2<cfs_heap_size &&
+		    cfs_heap[2*i+2]->vruntime < cfs_heap[menor]->vruntime)
+			menor=2*i+2;
+		if (menor==i)
+			return;
+		cfs_swap(i, menor);
+		i=menor;
+	}
+}
+
+static void cfs_insert(BCP *proc){
+	proc->heap_pos=cfs_heap_size;
+	cfs_heap[cfs_heap_size++]=proc;
+	cfs_sift_up(proc->heap_pos);
+}
+
+static void cfs_remove(BCP *proc){
+	int i=proc->heap_pos;
+
+	if (i<0)
+		return;
+	proc->heap_pos=-1;
+	if (i==--cfs_heap_size)
+		return;
+	cfs_heap[i]=cfs_heap[cfs_heap_size];
+	cfs_heap[i]->heap_pos=i;
+	cfs_sift_up(i);
+	cfs_sift_down(cfs_heap[i]->heap_pos);
+}
+
+static BCP * cfs_first(){
+	return cfs_heap_size ? cfs_heap[0] : NULL;
 }
 
 /*
- * Tratamiento de llamadas al sistema
+ * El vruntime mínimo del sistema solo avanza; sirve de referencia para
+ * colocar a los procesos nuevos y a los que despiertan
  */
-static void tratar_llamsis(){
-	int nserv, res;
+static void cfs_update_min(){
+	if (cfs_heap_size && cfs_heap[0]->vruntime > cfs_min_vruntime)
+		cfs_min_vruntime=cfs_heap[0]->vruntime;
+}
 
-	nserv=leer_registro(0);
-	if (nserv<NSERVICIOS)
-		res=(tabla_servicios[nserv].fservicio)();
-	else
-		res=-1;		/* servicio no existente */
-	escribir_registro(0,res);
-	return;
+/*
+ * Un proceso nuevo empieza una rodaja por detrás del mínimo, de modo que
+ * crear procesos no permita adelantar a los que ya están esperando
+ */
+static void cfs_place_new(BCP *proc){
+	proc->vruntime=cfs_min_vruntime + cfs_delta(proc, TICKS_POR_RODAJA);
+}
+
+/*
+ * Un proceso que despierta conserva su vruntime salvo que se haya quedado
+ * muy atrás: se le acerca al mínimo con un crédito de media rodaja para
+ * que responda pronto sin acaparar la UCP
+ */
+static void cfs_place_wakeup(BCP *proc){
+	unsigned long long credito=cfs_delta(proc, TICKS_POR_RODAJA/2);
+
+	if (cfs_min_vruntime > credito &&
+	    proc->vruntime < cfs_min_vruntime - credito)
+		proc->vruntime=cfs_min_vruntime - credito;
+}
+
+/*
+ * Carga el TICK al proceso en ejecución y devuelve 1 si hay otro listo
+ * cuyo vruntime es menor en más de la granularidad mínima
+ */
+static int cfs_tick(BCP *proc){
+	BCP *otro;
+
+	proc->vruntime+=cfs_delta(proc, 1);
+	cfs_sift_down(proc->heap_pos);
+	cfs_update_min();
+
+	otro=cfs_heap[0];
+	if (otro==proc) {
+		/* el siguiente candidato es el menor de los hijos de la raíz */
+		otro=NULL;
+		if (cfs_heap_size>1)
+			otro=cfs_heap[1];
+		if (cfs_heap_size>2 && cfs_heap[2]->vruntime < otro->vruntime)
+			otro=cfs_heap[2];
+	}
+	return otro!=NULL &&
+		proc->vruntime > otro->vruntime + cfs_delta(otro, CFS_GRANULARIDAD);
+}
+
+static void cfs_init(BCP *proc){
+	/* CFS no usa la rodaja, pero es lo que presta al esperar un mutex */
+	proc->robin_seconds=TICKS_POR_RODAJA;
+	proc->heap_pos=-1;
+	cfs_place_new(proc);
+}
+
+/*
+ * El vruntime ya refleja lo ejecutado: basta con recolocarlo en el montículo
+ */
+static void cfs_yield(BCP *proc){
+	cfs_remove(proc);
+	cfs_insert(proc);
+}
+
+static void cfs_wakeup(BCP *proc){
+	cfs_place_wakeup(proc);
+	cfs_insert(proc);
+}
+
+
+/*
+ * Planificación proporcional por stride. Cada TICK ejecutado avanza el
+ * pass del proceso en STRIDE1/tickets y se elige el de menor pass, de
+ * modo que la UCP se reparte en proporción a los tickets. Reutiliza el
+ * montículo de CFS usando el campo vruntime como pass.
+ */
+
+static unsigned long long stride_of(BCP *proc){
+	return STRIDE1 / proc->tickets;
+}
+
+static void stride_init(BCP *proc){
+	proc->heap_pos=-1;
+	proc->robin_seconds=TICKS_POR_RODAJA;
+	proc->vruntime=cfs_min_vruntime + stride_of(proc);
+}
+
+static int stride_tick(BCP *proc){
+	proc->vruntime+=stride_of(proc);
+	cfs_sift_down(proc->heap_pos);
+	cfs_update_min();
+	return --proc->robin_seconds <= 0;
+}
+
+static void stride_yield(BCP *proc){
+	proc->robin_seconds=TICKS_POR_RODAJA;
+	cfs_yield(proc);
+}
+
+/*
+ * Mientras está bloqueado el proceso no acumula crédito: vuelve como
+ * mínimo con el pass global
+ */
+static void stride_wakeup(BCP *proc){
+	if (proc->vruntime < cfs_min_vruntime)
+		proc->vruntime=cfs_min_vruntime;
+	proc->robin_seconds=TICKS_POR_RODAJA;
+	cfs_insert(proc);
+}
+
+/*
+ * Planificación por lotería. Se sortea entre los tickets de los procesos
+ * listos usando un árbol de Fenwick indexado por entrada de la tabla de
+ * procesos, así que insertar, eliminar y sortear cuestan O(log limite_procs).
+ */
+
+static unsigned int lottery_rand(){
+	lottery_seed ^= lottery_seed << 13;
+	lottery_seed ^= lottery_seed >> 17;
+	lottery_seed ^= lottery_seed << 5;
+	return lottery_seed;
+}
+
+static void lottery_add(BCP *proc, int tickets){
+	int i;
+
+	for (i=proc->ranura + 1; i<=limite_procs; i+=i & -i)
+		lottery_tree[i]+=tickets;
+	lottery_total+=tickets;
+}
+
+static void lottery_enqueue(BCP *proc){
+	lottery_add(proc, proc->tickets);
+}
+
+static void lottery_dequeue(BCP *proc){
+	lottery_add(proc, -(int)proc->tickets);
+}
+
+/*
+ * Busca la entrada cuyo intervalo de tickets contiene el número sorteado
+ */
+static BCP * lottery_pick_next(){
+	int pos=0, paso=1;
+	unsigned int premiado;
+
+	if (lottery_total==0)
+		return NULL;
+	premiado=lottery_rand() % lottery_total;
+	while (paso*2 <= limite_procs)
+		paso*=2;
+	for ( ; paso; paso/=2)
+		if (pos+paso <= limite_procs && lottery_tree[pos+paso] <= premiado) {
+			pos+=paso;
+			premiado-=lottery_tree[pos];
+		}
+	return BCP_ranura(pos);
+}
+
+/*
+ * Al agotar la rodaja se vuelve a sortear; el proceso sigue participando
+ */
+static void lottery_yield(BCP *proc){
+	proc->robin_seconds=TICKS_POR_RODAJA;
+}
+
+static void lottery_wakeup(BCP *proc){
+	proc->robin_seconds=TICKS_POR_RODAJA;
+	lottery_enqueue(proc);
+}
+
+/*
+ * Tablas de operaciones de las políticas disponibles
+ */
+static sched_ops fifo_ops={ "fifo", fifo_init, fifo_enqueue, fifo_dequeue,
+	fifo_pick_next, fifo_tick, fifo_yield, fifo_enqueue };
+
+static sched_ops rr_ops={ "rr", fifo_init, fifo_enqueue, fifo_dequeue,
+	fifo_pick_next, rr_tick, rr_yield, rr_wakeup };
+
+static sched_ops adapt_ops={ "adaptive", adapt_init, fifo_enqueue,
+	fifo_dequeue, fifo_pick_next, rr_tick, adapt_yield, adapt_wakeup };
+
+static sched_ops mlfq_ops={ "mlfq", mlfq_init, mlfq_insert, mlfq_remove,
+	mlfq_first, mlfq_tick, mlfq_yield, mlfq_wakeup };
+
+static sched_ops cfs_ops={ "cfs", cfs_init, cfs_insert, cfs_remove,
+	cfs_first, cfs_tick, cfs_yield, cfs_wakeup };
+
+static sched_ops stride_ops={ "stride", stride_init, cfs_insert, cfs_remove,
+	cfs_first, stride_tick, stride_yield, stride_wakeup };
+
+static sched_ops lottery_ops={ "lottery", fifo_init, lottery_enqueue,
+	lottery_dequeue, lottery_pick_next, rr_tick, lottery_yield,
+	lottery_wakeup };
+
+static sched_ops *politicas[]={ &fifo_ops, &rr_ops, &adapt_ops, &mlfq_ops,
+	&cfs_ops, &stride_ops, &lottery_ops };
+
+#define NUM_POLITICAS (sizeof(politicas)/sizeof(politicas[0]))
+
+/*
+ * Busca una política por su nombre
+ */
+static sched_ops * buscar_politica(char *nombre){
+	int i;
+
+	for (i=0; i<NUM_POLITICAS; i++)
+		if (strcmp(politicas[i]->name, nombre)==0)
+			return politicas[i];
+	return NULL;
+}
+
+/*
+ * Fija la política indicada por la variable de entorno PLANIF_ENV o,
+ * si no existe o no es válida, PLANIF_DEFECTO. Se llama una sola vez
+ * en el arranque, antes de crear el proceso inicial.
+ */
+static void elegir_planificador(){
+	char *nombre=getenv(PLANIF_ENV);
+
+	if (nombre!=NULL)
+		planif=buscar_politica(nombre);
+	if (planif==NULL) {
+		if (nombre!=NULL)
+			printk("-> POLITICA %s DESCONOCIDA\n", nombre);
+		planif=buscar_politica(PLANIF_DEFECTO);
+	}
+	printk("-> POLITICA DE PLANIFICACION: %s\n", planif->name);
+}
+
+/*
+ * Fija la regla de expulsión al despertar indicada por la variable de
+ * entorno EXPULSION_ENV o, si no existe o no es válida, EXPULSION_DEFECTO
+ */
+static void elegir_expulsion(){
+	char *nombre=getenv(EXPULSION_ENV);
+
+	if (nombre==NULL)
+		return;
+	if (strcmp(nombre, "nunca")==0)
+		regla_expulsion=EXPULSION_NUNCA;
+	else if (strcmp(nombre, "sueno")==0)
+		regla_expulsion=EXPULSION_SUENO;
+	else if (strcmp(nombre, "urgencia")==0)
+		regla_expulsion=EXPULSION_URGENCIA;
+	else if (strcmp(nombre, "ambas")==0)
+		regla_expulsion=EXPULSION_SUENO|EXPULSION_URGENCIA;
+	else
+		printk("-> REGLA DE EXPULSION %s DESCONOCIDA\n", nombre);
+}
+
+/*
+ * Clase de tiempo real. Los procesos que se unen con fijar_tiempo_real
+ * dejan la política normal y se planifican EDF por delante de ella: de
+ * entre los trabajos listos se ejecuta el de plazo absoluto más cercano.
+ * lista_edf se mantiene ordenada por plazo y lista_rt_espera guarda los
+ * que esperan al siguiente periodo, ya sea por haber terminado el trabajo
+ * o por haber agotado su presupuesto.
+ */
+
+/*
+ * Inserta un proceso en lista_edf detrás de los de plazo menor o igual
+ */
+static void edf_insert(BCP *proc){
+	BCP *ant=NULL, *paux=lista_edf.primero;
+
+	while (paux && paux->rt_abs_deadline <= proc->rt_abs_deadline) {
+		ant=paux;
+		paux=siguiente_BCP(&lista_edf, paux);
+	}
+	insertar_detras(&lista_edf, ant, proc);
+}
+
+static void edf_remove(BCP *proc){
+	eliminar_elem(&lista_edf, proc);
+}
+
+/*
+ * Comienza un nuevo trabajo del proceso con presupuesto completo
+ */
+static void edf_new_job(BCP *proc){
+	proc->rt_abs_deadline=proc->rt_release + proc->rt_deadline;
+	proc->rt_budget_left=proc->rt_budget;
+	proc->rt_throttled=0;
+	proc->rt_job_done=0;
+	proc->rt_missed=0;
+}
+
+/*
+ * Cuenta un fallo de plazo como mucho una vez por trabajo
+ */
+static void edf_check_deadline(BCP *proc){
+	if (proc->rt_job_done || proc->rt_missed ||
+	    ticks_sistema < proc->rt_abs_deadline)
+		return;
+	proc->rt_missed=1;
+	proc->rt_misses++;
+	printk("-> PROC %d PIERDE SU PLAZO (%d fallos)\n", proc->id,
+		proc->rt_misses);
+}
+
+/*
+ * Tratamiento por TICK de la clase: comprueba plazos y libera los
+ * trabajos cuyo periodo comienza, expulsando al proceso actual si el
+ * nuevo trabajo tiene más derecho a la UCP
+ */
+static void edf_release(){
+	BCP *proc, *siguiente;
+
+	for (proc=lista_edf.primero; proc; proc=siguiente_BCP(&lista_edf, proc))
+		edf_check_deadline(proc);
+
+	for (proc=lista_rt_espera.primero; proc; proc=siguiente) {
+		siguiente=siguiente_BCP(&lista_rt_espera, proc);
+		edf_check_deadline(proc);
+		if (ticks_sistema < proc->rt_release + proc->rt_period)
+			continue;
+
+		/* Los periodos se encadenan para no acumular deriva; si el
+			proceso va más de un periodo por detrás se resincroniza */
+		proc->rt_release+=proc->rt_period;
+		if (proc->rt_release + proc->rt_period <= ticks_sistema)
+			proc->rt_release=ticks_sistema;
+		edf_new_job(proc);
+
+		eliminar_elem(&lista_rt_espera, proc);
+		proc->estado=LISTO;
+		edf_insert(proc);
+		num_listos++;
+
+		if (p_proc_actual->estado==EJECUCION && (!p_proc_actual->rt_period ||
+		    proc->rt_abs_deadline < p_proc_actual->rt_abs_deadline))
+			activar_int_SW();
+	}
+}
+
+/*
+ * Descuenta el presupuesto del proceso en ejecución; al agotarlo queda
+ * estrangulado hasta el siguiente periodo y debe ceder la UCP
+ */
+static int edf_tick(BCP *proc){
+	if (--proc->rt_budget_left > 0)
+		return 0;
+	proc->rt_throttled=1;
+	printk("-> PROC %d AGOTA SU PRESUPUESTO DE TIEMPO REAL\n", proc->id);
+	return 1;
+}
+
+/*
+ * Reinserta al proceso que deja la UCP: si está estrangulado pasa a
+ * esperar el siguiente periodo
+ */
+static void edf_yield(BCP *proc){
+	edf_remove(proc);
+	if (proc->rt_throttled) {
+		proc->estado=BLOQUEADO;
+		insertar_ultimo(&lista_rt_espera, proc);
+	}
+	else {
+		proc->estado=LISTO;
+		edf_insert(proc);
+	}
+}
+
+/*
+ * Utilización de un proceso en tanto por mil, redondeada hacia arriba
+ * para que la prueba de admisión sea conservadora. Se calcula en 64 bits
+ * porque presupuesto*1000 desborda con presupuestos grandes.
+ */
+static unsigned int edf_utilization(unsigned int presupuesto,
+	unsigned int plazo){
+	return ((unsigned long long)presupuesto*1000 + plazo - 1) / plazo;
+}
+
+/*
+ * Grupos de procesos con cuota de UCP. Cada grupo puede consumir como
+ * mucho cuota TICKs por periodo; al agotarla se apartan todos sus procesos
+ * listos en la lista espera del grupo hasta el inicio del siguiente
+ * periodo. El grupo 0 no tiene límite y los procesos de tiempo real solo
+ * están sujetos a su propio presupuesto.
+ */
+
+/*
+ * Si el grupo del proceso está estrangulado lo aparta hasta el siguiente
+ * periodo y devuelve 1
+ */
+static int grupo_aparcar(BCP *proc){
+	grupo *g=&tabla_grupos[proc->grupo];
+
+	if (!g->estrangulado || proc->rt_period)
+		return 0;
+	proc->estado=BLOQUEADO;
+	donados_quitar(proc);
+	insertar_ultimo(&g->espera, proc);
+	return 1;
+}
+
+/*
+ * Mete al proceso en el grupo indicado. Solo se lleva la lista de
+ * miembros de los grupos con cuota, que son los que se estrangulan.
+ */
+static void grupo_entrar(BCP *proc, int num_grupo){
+	grupo *g=&tabla_grupos[num_grupo];
+
+	proc->grupo=num_grupo;
+	g->num_procs++;
+	if (num_grupo!=0)
+		insertar_ultimo(&g->miembros, proc);
+}
+
+/*
+ * Saca al proceso de su grupo, que queda libre si era el último
+ */
+static void grupo_salir(BCP *proc){
+	grupo *g=&tabla_grupos[proc->grupo];
+
+	if (proc->grupo==0) {
+		g->num_procs--;
+		return;
+	}
+	eliminar_elem(&g->miembros, proc);
+	if (--g->num_procs==0)
+		grupos_con_cuota--;
+}
+
+/*
+ * Frecuencia de reloj dinámica. Si se elige en el arranque, el reloj
+ * baja a TICK_LENTO interrupciones por segundo mientras no haya más de un
+ * proceso listo, ni procesos de tiempo real, ni procesos que vayan a
+ * despertar pronto; cada interrupción cuenta entonces como varios TICKs.
+ * Vuelve a TICK en cuanto hay competencia por la UCP.
+ */
+
+/*
+ * Activa el modo dinámico si lo indica la variable de entorno RELOJ_ENV
+ */
+static void elegir_reloj(){
+	char *modo=getenv(RELOJ_ENV);
+
+	if (modo!=NULL && strcmp(modo, "dinamico")==0)
+		reloj_dinamico=1;
+	else if (modo!=NULL && strcmp(modo, "fijo")!=0)
+		printk("-> MODO DE RELOJ %s DESCONOCIDO\n", modo);
+	printk("-> RELOJ %s\n", reloj_dinamico ? "DINAMICO" : "FIJO");
+}
+
+/*
+ * Reprograma el reloj si la frecuencia adecuada ha cambiado
+ */
+static void reloj_ajustar(){
+	int lento;
+
+	if (!reloj_dinamico)
+		return;
+	lento=num_listos<=1 && rt_utilization==0 && !rueda_cercana();
+	if (lento==(ticks_por_int>1))
+		return;
+	ticks_por_int=lento ? TICK/TICK_LENTO : 1;
+	iniciar_cont_reloj(lento ? TICK_LENTO : TICK);
+	printk("-> RELOJ A %d HZ\n", lento ? TICK_LENTO : TICK);
+}
+
+/*
+ * Devuelve 1 si la interrupción de reloj no tiene nada que hacer: no hay
+ * proceso en ejecución, ni trabajo en la rueda, ni tiempo real, ni cuotas
+ */
+static int tick_tranquilo(){
+	return p_proc_actual->estado!=EJECUCION && rt_utilization==0 &&
+		grupos_con_cuota==0 && rueda_tranquila();
+}
+
+/*
+ * Interfaz común que usa el resto del núcleo. Los procesos de tiempo
+ * real se tratan con la clase EDF y el resto con la política activa.
+ */
+
+/*
+ * Siguiente proceso a ejecutar: la clase de tiempo real va primero
+ */
+static BCP * pick_next(){
+	if (lista_edf.primero!=NULL)
+		return lista_edf.primero;
+	/* Los dueños de mutex con rodaja prestada pasan por delante */
+	if (lista_donados.primero!=NULL)
+		return lista_donados.primero;
+	return planif->pick_next();
+}
+
+/*
+ * Inicia los campos de planificación de un proceso recién creado
+ */
+static void ready_new(BCP *proc){
+	planif->init(proc);
+}
+
+/*
+ * Inserta un proceso en la estructura de listos
+ */
+static void ready_insert(BCP *proc){
+	num_listos++;
+	reloj_ajustar();
+	if (proc->rt_period)
+		edf_insert(proc);
+	else
+		planif->enqueue(proc);
+}
+
+/*
+ * Elimina un proceso de la estructura de listos
+ */
+static void ready_remove(BCP *proc){
+	num_listos--;
+	if (proc->rt_period)
+		edf_remove(proc);
+	else
+		planif->dequeue(proc);
+}
+
+/*
+ * Saca de listos a un proceso que va a bloquearse
+ */
+static void ready_block(BCP *proc){
+	proc->ticks_bloqueo=ticks_sistema;
+	donados_quitar(proc);
+	ready_remove(proc);
+}
+
+/*
+ * La regla de sueño no se aplica en FIFO, que nunca expulsa, ni a favor de
+ * un proceso que la política pondría detrás del actual: uno de la clase
+ * normal frente a uno de tiempo real o, en MLFQ, uno de una cola menos
+ * prioritaria
+ */
+static int expulsion_sueno(BCP *proc){
+	if (ticks_sistema - proc->ticks_bloqueo < EXPULSION_SUENO_MIN)
+		return 0;
+	if (planif==&fifo_ops || (p_proc_actual->rt_period && !proc->rt_period))
+		return 0;
+	if (planif==&mlfq_ops && !proc->rt_period && !p_proc_actual->rt_period &&
+		mlfq_index(proc) > mlfq_index(p_proc_actual))
+		return 0;
+	return 1;
+}
+
+/*
+ * Decide, según la regla de expulsión, si el proceso recién despertado
+ * debe quitarle la UCP al actual. En tal caso lo deja como preferido y
+ * activa la interrupción software para que el cambio sea inmediato.
+ */
+static void expulsion_despertar(BCP *proc){
+	int expulsar=0;
+
+	if (p_proc_actual==NULL || p_proc_actual->estado!=EJECUCION)
+		return;
+	if ((regla_expulsion & EXPULSION_SUENO) && expulsion_sueno(proc))
+		expulsar=1;
+	if ((regla_expulsion & EXPULSION_URGENCIA) && pick_next()==proc)
+		expulsar=1;
+	/* Los que despiertan en un mismo lote comparten una única expulsión */
+	if (!expulsar || proc_preferido!=NULL)
+		return;
+	printk("-> PROC %d EXPULSADO AL DESPERTAR %d\n", p_proc_actual->id, proc->id);
+	proc_preferido=proc;
+	activar_int_SW();
+}
+
+/*
+ * Devuelve a listos a un proceso que estaba bloqueado
+ */
+static void ready_wakeup(BCP *proc){
+	if (grupo_aparcar(proc))
+		return;
+	proc->estado=LISTO;
+	num_listos++;
+	reloj_ajustar();
+	if (proc->rt_period)
+		edf_insert(proc);
+	else
+		planif->wakeup(proc);
+	donados_poner(proc);
+	expulsion_despertar(proc);
+}
+
+/*
+ * Devuelve a listos al proceso que cede o es expulsado de la UCP
+ */
+static void ready_expire(BCP *proc){
+	if (proc->rt_period) {
+		edf_yield(proc);
+		if (proc->rt_throttled)
+			num_listos--;
+		return;
+	}
+	if (tabla_grupos[proc->grupo].estrangulado) {
+		planif->dequeue(proc);
+		grupo_aparcar(proc);
+		num_listos--;
+		return;
+	}
+	proc->estado=LISTO;
+	planif->yield(proc);
+}
+
+/*
+ * Tratamiento por TICK de la política: devuelve 1 si el proceso en
+ * ejecución debe ceder la UCP
+ */
+static int ready_tick(BCP *proc){
+	if (proc->rt_period)
+		return edf_tick(proc);
+	return planif->tick(proc);
+}
+
+/*
+ * Devuelve 1 si, sin haber pasado un TICK, hay otro proceso con más
+ * derecho a la UCP que el indicado
+ */
+static int ready_preempt(BCP *proc){
+	return pick_next()!=proc;
+}
+
+/*
+ * Aparta a los procesos listos de un grupo que ha agotado su cuota. El
+ * que está en ejecución se aparta al dejar la UCP.
+ */
+static void grupo_estrangular(int num_grupo){
+	grupo *g=&tabla_grupos[num_grupo];
+	BCP *proc;
+
+	for (proc=g->miembros.primero; proc; proc=siguiente_BCP(&g->miembros, proc)) {
+		if (proc->estado==LISTO && !proc->rt_period) {
+			ready_remove(proc);
+			grupo_aparcar(proc);
+		}
+	}
+}
+
+/*
+ * Carga un TICK al grupo del proceso en ejecución: devuelve 1 si el
+ * grupo está estrangulado y el proceso debe dejar la UCP
+ */
+static int grupo_tick(BCP *proc){
+	grupo *g=&tabla_grupos[proc->grupo];
+
+	g->consumo++;
+	g->ticks_total++;
+	if (g->cuota && !g->estrangulado && g->consumo >= g->cuota) {
+		g->estrangulado=1;
+		g->estrangulamientos++;
+		printk("-> GRUPO %d AGOTA SU CUOTA\n", proc->grupo);
+		grupo_estrangular(proc->grupo);
+	}
+	return g->estrangulado && !proc->rt_period;
+}
+
+/*
+ * Al empezar un nuevo periodo de un grupo se repone su cuota y se
+ * devuelven a listos los procesos apartados
+ */
+static void grupo_release(){
+	int i;
+	grupo *g;
+	BCP *proc;
+
+	for (i=1; i<MAX_GRUPOS; i++) {
+		g=&tabla_grupos[i];
+		if (g->num_procs==0 || ticks_sistema - g->inicio_periodo < g->periodo)
+			continue;
+		g->inicio_periodo=ticks_sistema;
+		g->consumo=0;
+		if (!g->estrangulado)
+			continue;
+		g->estrangulado=0;
+		printk("-> GRUPO %d RECUPERA SU CUOTA\n", i);
+		while ((proc=g->espera.primero)!=NULL) {
+			eliminar_primero(&g->espera);
+			ready_wakeup(proc);
+		}
+	}
+}
+
+/*
+ * Espera a que se produzca una interrupcion
+ */
+static void espera_int(){
+	int nivel;
+
+	/* Por limpieza en la ejecución se comenta esta parte
+	printk("-> NO HAY LISTOS. ESPERA INT\n"); */
+
+	/* Aprovecha el tiempo ocioso para liberar los procesos terminados */
+	recoger_terminados(-1);
+
+	/* Baja al m�nimo el nivel de interrupci�n mientras espera */
+	nivel=fijar_nivel_int(NIVEL_1);
+	halt();
+	fijar_nivel_int(nivel);
+}
+
+/*
+ * Funci�n de planificacion: devuelve el proceso que elige la política
+ * activa y lo marca en ejecución.
+ */
+static BCP * planificador(){
+	BCP *proc;
+
+	do {
+		while ((proc=pick_next())==NULL)
+			espera_int();		/* No hay nada que hacer */
+	} while (proc->carga_pendiente && !cargar_tarea(proc));
+	proc->estado=EJECUCION;
+	return proc;
+}
+
+/*
+ * Pasa la UCP directamente al proceso listo indicado, sin consultar a la
+ * política. Si ya no está listo, o hay procesos de tiempo real listos,
+ * que conservan la preferencia, se usa el planificador.
+ */
+static BCP * planificar_hacia(BCP *proc){
+	if (proc==NULL || proc->estado!=LISTO || lista_edf.primero!=NULL)
+		return planificador();
+	if (proc->carga_pendiente && !cargar_tarea(proc))
+		return planificador();
+	proc->estado=EJECUCION;
+	return proc;
+}
+
+/*
+ *
+ * Funciones de la reserva de pilas
+ *	elegir_reserva_pilas recortar_reserva_pilas obtener_pila devolver_pila
+ *	instante_ns contar_arranque
+ *
+ * Las pilas de los procesos que terminan se guardan, hasta un máximo,
+ * para dárselas a los siguientes que se creen sin pasar por crear_pila.
+ *
+ */
+
+/*
+ * Fija el máximo de la reserva si lo indica la variable de entorno
+ * RESERVA_PILAS_ENV; 0 la desactiva
+ */
+static void elegir_reserva_pilas(){
+	char *maximo=getenv(RESERVA_PILAS_ENV);
+
+	if (maximo!=NULL)
+		max_pilas_reserva=atoi(maximo);
+	if (max_pilas_reserva<0)
+		max_pilas_reserva=0;
+	if (max_pilas_reserva>RESERVA_PILAS_TOPE)
+		max_pilas_reserva=RESERVA_PILAS_TOPE;
+	printk("-> RESERVA DE PILAS: %d\n", max_pilas_reserva);
+}
+
+/*
+ * Libera las pilas que sobran si se ha reducido el máximo
+ */
+static void recortar_reserva_pilas(){
+	while (num_pilas_reserva>max_pilas_reserva)
+		liberar_pila(reserva_pilas[--num_pilas_reserva]);
+}
+
+/*
+ * Devuelve una pila de la reserva o, si está vacía, una nueva
+ */
+static void * obtener_pila(){
+	if (num_pilas_reserva>0) {
+		pilas_aciertos++;
+		return reserva_pilas[--num_pilas_reserva];
+	}
+	pilas_fallos++;
+	return crear_pila(TAM_PILA);
+}
+
+/*
+ * Guarda la pila de un proceso terminado si cabe en la reserva
+ */
+static void devolver_pila(void *pila){
+	if (num_pilas_reserva<max_pilas_reserva)
+		reserva_pilas[num_pilas_reserva++]=pila;
+	else
+		liberar_pila(pila);
+}
+
+/*
+ * Instante actual en nanosegundos, para medir el arranque de los procesos
+ */
+static unsigned long long instante_ns(){
+	struct timespec ahora;
+
+	clock_gettime(CLOCK_MONOTONIC, &ahora);
+	return (unsigned long long)ahora.tv_sec*1000000000ULL + ahora.tv_nsec;
+}
+
+/*
+ * Anota el tiempo desde que se empezó a crear el proceso hasta su primera
+ * llamada al sistema, que es cuando se sabe que ya ha ejecutado
+ */
+static void contar_arranque(BCP *proc){
+	arranque_total_ns+=instante_ns() - proc->arranque_ns;
+	num_arranques++;
+	proc->arranque_ns=0;
+}
+
+/*
+ *
+ * Funciones de la caché de imágenes
+ *	elegir_cache_imagenes elegir_carga_diferida buscar_imagen
+ *	imagen_menos_usada descargar_imagen desalojar_imagen
+ *	recortar_cache_imagenes obtener_imagen compartir_imagen soltar_imagen
+ *
+ * Las imágenes se guardan por nombre de programa junto con los procesos
+ * que las usan. Cuando se quedan sin procesos se conservan, hasta un
+ * máximo, para que la siguiente creación no cargue de nuevo el programa;
+ * se desaloja la que lleva más tiempo sin usarse. Igual que ya ocurre con
+ * los procesos que ejecutan a la vez el mismo programa, los sucesivos
+ * comparten sus datos globales, que no se vuelven a iniciar. Como eso
+ * cambia el comportamiento de los programas con globales modificables, la
+ * caché está desactivada salvo que se pida con CACHE_IMAGENES_ENV o
+ * fijar_cache_imagenes. Sin ella no se busca ningún programa en la tabla,
+ * pero la imagen de un lote de crear_procesos se guarda mientras la usan
+ * sus procesos, que la comparten, y se desaloja con el último.
+ *
+ * liberar_imagen apaga el sistema cuando no queda ninguna imagen cargada,
+ * así que la caché se vacía al terminar el último proceso, y la última
+ * imagen se retiene mientras haya procesos con la carga pendiente.
+ *
+ */
+
+/*
+ * Fija el máximo de imágenes sin procesos si lo indica la variable de
+ * entorno CACHE_IMAGENES_ENV; 0 desactiva la caché
+ */
+static void elegir_cache_imagenes(){
+	char *maximo=getenv(CACHE_IMAGENES_ENV);
+
+	if (maximo!=NULL)
+		max_imagenes_libres=atoi(maximo);
+	if (max_imagenes_libres<0)
+		max_imagenes_libres=0;
+	if (max_imagenes_libres>TABLA_IMAGENES)
+		max_imagenes_libres=TABLA_IMAGENES;
+	printk("-> CACHE DE IMAGENES: %d\n", max_imagenes_libres);
+}
+
+/*
+ * Activa la carga diferida de los programas si lo indica la variable de
+ * entorno CARGA_DIFERIDA_ENV
+ */
+static void elegir_carga_diferida(){
+	char *activa=getenv(CARGA_DIFERIDA_ENV);
+
+	if (activa!=NULL)
+		carga_diferida=(atoi(activa)!=0);
+	printk("-> CARGA DIFERIDA: %d\n", carga_diferida);
+}
+
+/*
+ * Devuelve la entrada del programa o -1 si no está en la caché
+ */
+static int buscar_imagen(char *prog){
+	int i;
+
+	for (i=0; i<TABLA_IMAGENES; i++)
+		if (tabla_imagenes[i].nombre[0] &&
+		    strcmp(tabla_imagenes[i].nombre, prog)==0)
+			return i;
+	return -1;
+}
+
+/*
+ * Devuelve la imagen sin procesos que lleva más tiempo sin usarse, o -1
+ */
+static int imagen_menos_usada(){
+	int i, elegida=-1;
+
+	for (i=0; i<TABLA_IMAGENES; i++)
+		if (tabla_imagenes[i].nombre[0] && tabla_imagenes[i].refs==0 &&
+		    (elegida<0 || tabla_imagenes[i].ultimo_uso <
+				tabla_imagenes[elegida].ultimo_uso))
+			elegida=i;
+	return elegida;
+}
+
+/*
+ * Libera una imagen salvo que sea la última cargada y queden procesos por
+ * cargar, que se retiene hasta que se cargue otra
+ */
+static void descargar_imagen(void *imagen){
+	if (imagenes_cargadas==1 && procs_pendientes>0) {
+		imagen_retenida=imagen;
+		return;
+	}
+	imagenes_cargadas--;
+	liberar_imagen(imagen);
+}
+
+/*
+ * Libera una imagen sin procesos y deja libre su entrada
+ */
+static void desalojar_imagen(int i){
+	tabla_imagenes[i].nombre[0]='\0';
+	num_imagenes_libres--;
+	imagenes_desalojos++;
+	descargar_imagen(tabla_imagenes[i].info_mem);
+}
+
+/*
+ * Desaloja imágenes sin procesos hasta no pasar del máximo
+ */
+static void recortar_cache_imagenes(){
+	while (num_imagenes_libres>max_imagenes_libres)
+		desalojar_imagen(imagen_menos_usada());
+}
+
+/*
+ * Devuelve la imagen del programa, cargándolo solo si no está en la
+ * caché, y la entrada que ocupa en ella (-1 si no se ha podido guardar).
+ * Con lote se guarda aunque la caché esté desactivada.
+ */
+static void * obtener_imagen(char *prog, void **pc_inicial, int *entrada,
+	int lote){
+	int i;
+	void *imagen;
+	unsigned long long inicio;
+
+	procs_con_imagen++;
+	i=max_imagenes_libres ? buscar_imagen(prog) : -1;
+	if (i>=0) {
+		imagenes_aciertos++;
+		if (tabla_imagenes[i].refs++==0)
+			num_imagenes_libres--;
+		*pc_inicial=tabla_imagenes[i].pc_inicial;
+		*entrada=i;
+		return tabla_imagenes[i].info_mem;
+	}
+
+	imagenes_fallos++;
+	inicio=instante_ns();
+	imagen=crear_imagen(prog, pc_inicial);
+	imagenes_carga_ns+=instante_ns() - inicio;
+	*entrada=-1;
+	if (imagen==NULL) {
+		procs_con_imagen--;
+		return NULL;
+	}
+
+	/* Ya no hace falta la que se retenía para no apagar el sistema */
+	imagenes_cargadas++;
+	if (imagen_retenida!=NULL) {
+		descargar_imagen(imagen_retenida);
+		imagen_retenida=NULL;
+	}
+
+	/* Se guarda en una entrada libre o en la de la imagen menos usada */
+	if ((max_imagenes_libres==0 && !lote) || strlen(prog)>=MAX_NOM_PROG)
+		return imagen;
+	for (i=0; i<TABLA_IMAGENES && tabla_imagenes[i].nombre[0]; i++);
+	if (i==TABLA_IMAGENES && (i=imagen_menos_usada())>=0)
+		desalojar_imagen(i);
+	if (i<0)
+		return imagen;
+	strcpy(tabla_imagenes[i].nombre, prog);
+	tabla_imagenes[i].info_mem=imagen;
+	tabla_imagenes[i].pc_inicial=*pc_inicial;
+	tabla_imagenes[i].refs=1;
+	*entrada=i;
+	return imagen;
+}
+
+/*
+ * Añade un proceso más a una imagen de la caché que ya se está usando
+ */
+static void compartir_imagen(int i){
+	procs_con_imagen++;
+	imagenes_aciertos++;
+	tabla_imagenes[i].refs++;
+}
+
+/*
+ * Deja de usar la imagen del proceso, si llegó a cargarla. Si era el
+ * último proceso vivo se liberan todas, lo que apaga el sistema.
+ */
+static void soltar_imagen(BCP *proc){
+	int i=proc->imagen;
+	void *imagen;
+
+	if (proc->info_mem!=NULL) {
+		procs_con_imagen--;
+		if (i<0)
+			descargar_imagen(proc->info_mem);
+		else if (--tabla_imagenes[i].refs==0) {
+			tabla_imagenes[i].ultimo_uso=++usos_imagenes;
+			num_imagenes_libres++;
+			recortar_cache_imagenes();
+		}
+	}
+
+	if (procs_con_imagen==0 && procs_pendientes==0) {
+		while ((i=imagen_menos_usada())>=0)
+			desalojar_imagen(i);
+		if ((imagen=imagen_retenida)!=NULL) {
+			imagen_retenida=NULL;
+			descargar_imagen(imagen);
+		}
+	}
+}
+
+/*
+ *
+ * Funciones de liberación de los procesos terminados
+ *	padre_vivo soltar_zombi reciclar_zombi recoger_proceso
+ *	recoger_terminados terminar_tarea liberar_proceso
+ *
+ * Al terminar, el proceso sólo sale de la planificación y pasa a la lista
+ * de terminados; sus mutex, temporizadores, imagen, pila y entrada de la
+ * tabla se liberan después, en la espera ociosa, en la interrupción de
+ * reloj o antes de crear procesos. Así el cambio al siguiente proceso no
+ * depende de los recursos que tuviera el que termina.
+ *
+ * Si su padre sigue vivo, la entrada no se libera: el proceso queda ZOMBI
+ * con su estado de salida hasta que el padre lo recoge con
+ * esperar_proceso o termina. Si la tabla se llena se reutilizan las
+ * entradas de los zombis más antiguos.
+ *
+ */
+
+/*
+ * Devuelve el padre del proceso si todavía no ha terminado
+ */
+static BCP * padre_vivo(BCP *proc){
+	BCP *padre=buscar_BCP(proc->padre);
+
+	if (padre==NULL || padre->estado==TERMINANDO || padre->estado==ZOMBI)
+		return NULL;
+	return padre;
+}
+
+/*
+ * Libera la entrada de un zombi de padre
+ */
+static void soltar_zombi(BCP *zombi, BCP *padre){
+	eliminar_elem(&padre->zombis, zombi);
+	eliminar_elem(&lista_zombis, zombi);
+	liberar_BCP(zombi->ranura);
+}
+
+/*
+ * Libera la entrada del zombi más antiguo, perdiendo su estado de salida.
+ * Devuelve 0 si no hay ninguno.
+ */
+static int reciclar_zombi(){
+	BCP *zombi=lista_zombis.primero;
+
+	if (zombi==NULL)
+		return 0;
+	soltar_zombi(zombi, buscar_BCP(zombi->padre));
+	return 1;
+}
+
+/*
+ * Libera todos los recursos de un proceso terminado. La imagen se suelta
+ * la última porque, si era el último proceso, se apaga el sistema.
+ */
+static void recoger_proceso(BCP *proc){
+	BCP *padre;
+
+	/* Se cierran todos los mutex que utilizaba */
+	for(int i = 0; i < proc->num_descriptores; i++){
+		if(proc->descriptores[i].tipo == DESC_MUTEX) cerrar_descriptor(proc, i);
+	}
+	free(proc->descriptores);
+	proc->descriptores = NULL;
+
+	/* Los temporizadores del proceso quedan libres */
+	for(int i = 0; i < MAX_TEMPORIZADORES; i++){
+		if(tabla_temporizadores[i].propietario == proc)
+			tabla_temporizadores[i].propietario = NULL;
+	}
+
+	if (proc->pila!=NULL)
+		devolver_pila(proc->pila);
+
+	/* Sus zombis ya no los puede esperar nadie */
+	while (proc->zombis.primero!=NULL)
+		soltar_zombi(proc->zombis.primero, proc);
+
+	/* La entrada queda libre para otro proceso con otro identificador,
+		salvo que el padre pueda esperarlo todavía */
+	if ((padre=padre_vivo(proc))!=NULL) {
+		proc->estado=ZOMBI;
+		insertar_ultimo(&padre->zombis, proc);
+		insertar_ultimo(&lista_zombis, proc);
+	}
+	else
+		liberar_BCP(proc->ranura);
+
+	soltar_imagen(proc); /* liberar mapa */
+}
+
+/*
+ * Libera como mucho max procesos terminados, todos si es negativo, y
+ * devuelve cuántos ha liberado
+ */
+static int recoger_terminados(int max){
+	int nivel, recogidos=0;
+	unsigned long long inicio;
+	BCP *proc;
+
+	if (lista_terminados.primero==NULL)
+		return 0;
+
+	nivel=fijar_nivel_int(NIVEL_3);
+	inicio=instante_ns();
+	while ((proc=lista_terminados.primero)!=NULL && recogidos!=max) {
+		eliminar_primero(&lista_terminados);
+		recogidos++;
+		num_recogidos++;
+		recoger_proceso(proc);
+	}
+	recogida_total_ns+=instante_ns() - inicio;
+	fijar_nivel_int(nivel);
+	return recogidos;
+}
+
+/*
+ * Saca de la planificación a un proceso que termina con el estado de
+ * salida indicado y deja sus recursos para recoger_terminados
+ */
+static void terminar_tarea(BCP *proc, int codigo){
+	BCP *padre;
+
+	proc->codigo_salida=codigo;
+	proc->estado=TERMINANDO;
+	donados_quitar(proc);
+	ready_remove(proc); /* proc. fuera de listos */
+	total_tickets-=proc->tickets;
+	rt_utilization-=proc->rt_util;
+	grupo_salir(proc);
+	insertar_ultimo(&lista_terminados, proc);
+
+	/* El padre que lo espera puede seguir sin aguardar a la recogida */
+	while ((padre=proc->esperando.primero)!=NULL) {
+		eliminar_primero(&proc->esperando);
+		ready_wakeup(padre);
+	}
+}
+
+/*
+ *
+ * Funcion auxiliar que termina proceso actual con el estado de salida
+ * indicado.
+ * Usada por llamada terminar_proceso y por rutinas que tratan excepciones
+ *
+ */
+static void liberar_proceso(int codigo){
+	BCP * p_proc_anterior;
+	unsigned long long inicio=instante_ns();
+
+	terminar_tarea(p_proc_actual, codigo);
+
+	/* Realizar cambio de contexto */
+	p_proc_anterior=p_proc_actual;
+	p_proc_actual=planificador();
+
+	printk("-> C.CONTEXTO POR FIN: de %d a %d\n",
+			p_proc_anterior->id, p_proc_actual->id);
+
+	fin_total_ns+=instante_ns() - inicio;
+	num_fines++;
+	cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
+        return; /* no deber�a llegar aqui */
+}
+
+/*
+ *
+ * Funciones relacionadas con el tratamiento de interrupciones
+ *	excepciones: exc_arit exc_mem
+ *	interrupciones de reloj: int_reloj
+ *	interrupciones del terminal: int_terminal
+ *	llamadas al sistemas: llam_sis
+ *	interrupciones SW: int_sw
+ *
+ */
+
+/*
+ * Tratamiento de excepciones aritmeticas
+ */
+static void exc_arit(){
+
+	if (!viene_de_modo_usuario())
+		panico("excepcion aritmetica cuando estaba dentro del kernel");
+
+
+	printk("-> EXCEPCION ARITMETICA EN PROC %d\n", p_proc_actual->id);
+	liberar_proceso(SALIDA_EXCEPCION);
+
+        return; /* no deber�a llegar aqui */
+}
+
+/*
+ * Tratamiento de excepciones en el acceso a memoria
+ */
+static void exc_mem(){
+
+	if (!viene_de_modo_usuario())
+		panico("excepcion de memoria cuando estaba dentro del kernel");
+
+
+	printk("-> EXCEPCION DE MEMORIA EN PROC %d\n", p_proc_actual->id);
+	liberar_proceso(SALIDA_EXCEPCION);
+
+        return; /* no deber�a llegar aqui */
+}
+
+/*
+ * Tratamiento de interrupciones de terminal
+ */
+static void int_terminal(){
+	char car;
+
+	car = leer_puerto(DIR_TERMINAL);
+	printk("-> TRATANDO INT. DE TERMINAL %c\n", car);
+
+        return;
+}
+
+
+void round_robin(){
+	/* Solo se contabiliza el TICK si el proceso actual sigue en ejecución */
+	if(p_proc_actual->estado != EJECUCION) return;
+
+	/* Contabilidad del uso de UCP para comparar con el reparto objetivo */
+	p_proc_actual->ticks_cpu++;
+	ticks_ocupados++;
+
+	/* El TICK se carga también a la cuota del grupo del proceso */
+	int throttled = grupo_tick(p_proc_actual);
+
+	/* Lo que le han prestado los que esperan sus mutex se consume antes
+		que su propia rodaja; ese TICK no se cuenta en la política */
+	int expired = 0;
+	if(p_proc_actual->donacion > 0 && !p_proc_actual->rt_period) consumir_donacion(p_proc_actual);
+	else expired = ready_tick(p_proc_actual);
+
+	/* Como se indica en el manual del minikernel, las interrupciones de Software se
+		realizan para el tratamiento de cambios de contexto involuntarios */
+	if(expired || throttled) activar_int_SW();
+}
+
+
+
+/*
+ * Tratamiento de interrupciones de reloj
+ */
+static void int_reloj(){
+
+	/* Para mayor limpieza en la ejecución del código se prescinde de este print
+	printk("-> TRATANDO INT. DE RELOJ\n");	*/
+	int i;
+
+	/* Con el reloj lento cada interrupción cuenta como varios TICKs */
+	ticks_sistema += ticks_por_int;
+	interrupciones_evitadas += ticks_por_int - 1;
+
+	/* Camino rápido, de coste constante, si no hay nada que hacer */
+	if(tick_tranquilo()){
+		rueda_saltar();
+		ticks_tranquilos++;
+		return;
+	}
+
+	timer();
+	edf_release();
+	grupo_release();
+	for(i = 0; i < ticks_por_int; i++) round_robin();
+	reloj_ajustar();
+	recoger_terminados(RECOGER_POR_TICK);
+
+        return;
+}
+
+/*
+ * Tratamiento de llamadas al sistema
+ */
+static void tratar_llamsis(){
+	int nserv, res;
+
+	nserv=leer_registro(0);
+	if (p_proc_actual->arranque_ns)
+		contar_arranque(p_proc_actual);
+	if (nserv<NSERVICIOS)
+		res=(tabla_servicios[nserv].fservicio)();
+	else
+		res=-1;		/* servicio no existente */
+	escribir_registro(0,res);
+	return;
+}
+
+/*
+ * Tratamiento de interrupciuones software
+ */
+static void int_sw(){
+
+	printk("-> TRATANDO INT. SW\n");
+
+	robin_process_change();
+
+	return;
+}
+
+/*
+ *
+ * Funciones auxiliares que crean procesos reservando sus recursos.
+ * Usadas por las llamadas crear_proceso y crear_procesos.
+ *
+ * Con la carga diferida activa, crear un proceso sólo reserva su BCP; la
+ * imagen y la pila se obtienen con cargar_tarea cuando el planificador lo
+ * elige por primera vez. Si el programa no se puede cargar el proceso
+ * termina con el estado SALIDA_CARGA, que recibe el padre al esperarlo.
+ *
+ */
+
+/*
+ * Asigna al proceso la imagen y una pila y prepara su contexto inicial
+ */
+static void preparar_contexto(BCP *p_proc, void *imagen, void *pc_inicial){
+	p_proc->info_mem=imagen;
+	p_proc->pila=obtener_pila();
+	fijar_contexto_ini(p_proc->info_mem, p_proc->pila, TAM_PILA,
+		pc_inicial,
+		&(p_proc->contexto_regs));
+}
+
+/*
+ * Rellena el BCP de un proceso nuevo y lo deja listo para ejecutar. Sin
+ * imagen, su contexto se prepara al cargarla.
+ */
+static void iniciar_tarea(BCP *p_proc, void *imagen, void *pc_inicial,
+			unsigned long long inicio){
+	if (imagen!=NULL)
+		preparar_contexto(p_proc, imagen, pc_inicial);
+	else {
+		p_proc->info_mem=NULL;
+		p_proc->pila=NULL;
+	}
+	p_proc->id=p_proc->generacion*MAX_PROC_TOPE + p_proc->ranura;
+	p_proc->arranque_ns=inicio;
+	p_proc->estado=LISTO;
+
+	/* Lo puede esperar el proceso que lo crea */
+	p_proc->padre = (p_proc_actual != NULL) ? p_proc_actual->id : -1;
+	p_proc->codigo_salida = 0;
+
+	/* La tabla de descriptores se reserva al abrir el primero */
+	p_proc->descriptores = NULL;
+	p_proc->num_descriptores = 0;
+	p_proc->descriptor_libre = -1;
+	p_proc->rodaja_prestada = 0;
+	p_proc->donacion = 0;
+	p_proc->donado_total = 0;
+	iniciar_lista(&p_proc->esperando, ENLACE_ESPERA);
+	iniciar_lista(&p_proc->zombis, ENLACE_LISTOS);
+
+	/* La prioridad estática y los tickets se heredan del proceso creador */
+	if(p_proc_actual != NULL){
+		p_proc->priority = p_proc_actual->priority;
+		p_proc->tickets = p_proc_actual->tickets;
+	}
+	else{
+		p_proc->priority = PRIORIDAD_DEFECTO;
+		p_proc->tickets = TICKETS_DEFECTO;
+	}
+	total_tickets += p_proc->tickets;
+
+	/* El uso de UCP se mide desde la creación */
+	p_proc->ticks_cpu = 0;
+	p_proc->ticks_inicio = ticks_ocupados;
+
+	/* El grupo con cuota de UCP se hereda del proceso creador */
+	grupo_entrar(p_proc, (p_proc_actual != NULL) ? p_proc_actual->grupo : 0);
+
+	/* La holgura de los temporizadores también se hereda */
+	p_proc->holgura = (p_proc_actual != NULL) ? p_proc_actual->holgura : 0;
+
+	/* Todo proceso empieza fuera de la clase de tiempo real */
+	p_proc->rt_period = 0;
+	p_proc->rt_util = 0;
+	p_proc->rt_misses = 0;
+
+	/* A la hora de crear el proceso deben establecerse el número de TICKS
+		de round robin o el tiempo virtual con el que empieza */
+	ready_new(p_proc);
+
+	/* lo inserta al final de cola de listos, salvo que su grupo
+		haya agotado la cuota */
+	if (!grupo_aparcar(p_proc))
+		ready_insert(p_proc);
+}
+
+/*
+ * Crea hasta n procesos que ejecutan el mismo programa y guarda sus
+ * identificadores en pids. La imagen se obtiene una sola vez y la
+ * comparten todos, esté o no activada la caché. Devuelve los procesos creados, que pueden ser menos si se llena
+ * la tabla, o -1 si no se ha creado ninguno.
+ */
+static int crear_tareas(char *prog, int n, int *pids){
+	void * imagen=NULL, *pc_inicial;
+	int creados;
+	int proc, entrada=-1, diferir;
+	BCP *p_proc;
+	unsigned long long inicio=instante_ns();
+
+	/* Los terminados pendientes devuelven antes su pila e imagen */
+	recoger_terminados(n);
+
+	/* El proceso inicial lo crea el núcleo y se carga siempre */
+	diferir = carga_diferida && p_proc_actual!=NULL &&
+		strlen(prog)<MAX_NOM_PROG;
+
+	for (creados=0; creados<n; creados++) {
+		proc=buscar_BCP_libre();
+		if (proc==-1 && reciclar_zombi())
+			proc=buscar_BCP_libre();
+		if (proc==-1)
+			break;	/* no hay entrada libre */
+
+		/* A rellenar el BCP ... */
+		p_proc=BCP_ranura(proc);
+
+		if (diferir) {
+			strcpy(p_proc->programa, prog);
+			p_proc->carga_pendiente=1;
+			procs_pendientes++;
+			p_proc->imagen=-1;
+			iniciar_tarea(p_proc, NULL, NULL, inicio);
+			pids[creados]=p_proc->id;
+			continue;
+		}
+
+		/* crea la imagen de memoria leyendo ejecutable la primera vez;
+			los demás la comparten */
+		if (creados==0 || entrada<0)
+			imagen=obtener_imagen(prog, &pc_inicial, &entrada, n>1);
+		else
+			compartir_imagen(entrada);
+		if (imagen==NULL) {
+			liberar_BCP(proc);
+			break; /* fallo al crear imagen */
+		}
+		p_proc->imagen=entrada;
+		p_proc->carga_pendiente=0;
+		iniciar_tarea(p_proc, imagen, pc_inicial, inicio);
+		pids[creados]=p_proc->id;	/* identificador del nuevo proceso */
+	}
+
+	num_creados+=creados;
+	creacion_total_ns+=instante_ns() - inicio;
+	return creados ? creados : -1;
+}
+
+/*
+ * Carga el programa de un proceso creado con la carga diferida. Si no lo
+ * consigue, el proceso termina y devuelve 0.
+ */
+static int cargar_tarea(BCP *proc){
+	void *imagen, *pc_inicial;
+	int entrada;
+	unsigned long long inicio=instante_ns();
+
+	proc->carga_pendiente=0;
+	procs_pendientes--;
+	imagen=obtener_imagen(proc->programa, &pc_inicial, &entrada, 0);
+	if (imagen==NULL) {
+		printk("-> NO SE PUEDE CARGAR %s EN PROC %d\n", proc->programa, proc->id);
+		terminar_tarea(proc, SALIDA_CARGA);
+		return 0;
+	}
+	proc->imagen=entrada;
+	preparar_contexto(proc, imagen, pc_inicial);
+
+	cargas_diferidas++;
+	carga_diferida_ns+=instante_ns() - inicio;
+	return 1;
+}
+
+/*
+ * Función que crea un proceso
+ */
+static int crear_tarea(char *prog){
+	int pid;
+
+	if (crear_tareas(prog, 1, &pid)<0)
+		return -1;
+	return pid;
+}
+
+/*
+ *
+ * Rutinas que llevan a cabo las llamadas al sistema
+ *	sis_crear_proceso sis_crear_procesos sis_escribir
+ *
+ */
+
+/*
+ * Tratamiento de llamada al sistema crear_proceso. Llama a la
+ * funcion auxiliar crear_tarea sis_terminar_proceso
+ */
+int sis_crear_proceso(){
+	char *prog;
+	int res;
+
+	printk("-> PROC %d: CREAR PROCESO\n", p_proc_actual->id);
+	prog=(char *)leer_registro(1);
+	res=crear_tarea(prog);
+	return res;
+}
+
+/*
+ * Tratamiento de llamada al sistema crear_procesos. Crea en una sola
+ * llamada n procesos del mismo programa y devuelve sus identificadores
+ * en el vector pids
+ */
+int sis_crear_procesos(){
+	char *prog;
+	int n, *pids;
+
+	prog=(char *)leer_registro(1);
+	n=(int)leer_registro(2);
+	pids=(int *)leer_registro(3);
+	printk("-> PROC %d: CREAR %d PROCESOS\n", p_proc_actual->id, n);
+	if (n<=0)
+		return -1;
+	return crear_tareas(prog, n, pids);
+}
+
+/*
+ * Tratamiento de llamada al sistema escribir. Llama simplemente a la
+ * funcion de apoyo escribir_ker
+ */
+int sis_escribir()
+{
+	char *texto;
+	unsigned int longi;
+
+	texto=(char *)leer_registro(1);
+	longi=(unsigned int)leer_registro(2);
+
+	escribir_ker(texto, longi);
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema terminar_proceso. Llama a la
+ * funcion auxiliar liberar_proceso con el estado de salida del registro 1
+ */
+int sis_terminar_proceso(){
+	int codigo=(int)leer_registro(1);
+
+	printk("-> FIN PROCESO %d\n", p_proc_actual->id);
+
+	liberar_proceso(codigo);
+
+        return 0; /* no deber�a llegar aqui */
+}
+
+int obtener_id_pr(){
+	int id = p_proc_actual->id;
+	printk("ID del proceso actual es: %d\n", id);
+	return id;
+}
+
+/*
+ *	Esperar proceso: bloquea al proceso actual hasta que termine el hijo
+ *	indicado, deja su estado de salida y libera su entrada. Devuelve -1
+ *	si no es un hijo suyo o ya se ha recogido.
+ */
+int esperar_proceso(int pid, int *estado){
+
+	int child_pid = (int)leer_registro(1);
+	int *status = (int *)leer_registro(2);
+
+	int interruption_level = fijar_nivel_int(NIVEL_3);
+
+	BCPptr waiting_process = p_proc_actual;
+	BCPptr child_process = buscar_BCP(child_pid);
+
+	if(child_process == NULL || child_process->padre != waiting_process->id){
+		printk("El proceso %d no es un hijo que se pueda esperar.\n", child_pid);
+		fijar_nivel_int(interruption_level);
+		return -1;
+	}
+
+	/* Se bloquea hasta que el hijo termine */
+	if(child_process->estado != TERMINANDO && child_process->estado != ZOMBI){
+		waiting_process->estado = BLOQUEADO;
+		ready_block(waiting_process);
+		insertar_ultimo(&child_process->esperando, waiting_process);
+
+		p_proc_actual = planificador();
+
+		fijar_nivel_int(interruption_level);
+
+		cambio_contexto(&(waiting_process->contexto_regs), &(p_proc_actual->contexto_regs));
+
+		interruption_level = fijar_nivel_int(NIVEL_3);
+
+		/* Si la tabla se llenó mientras tanto, la entrada puede ser de otro */
+		if(buscar_BCP(child_pid) != child_process || child_process->padre != waiting_process->id){
+			printk("El estado de salida de %d se ha perdido.\n", child_pid);
+			fijar_nivel_int(interruption_level);
+			return -1;
+		}
+	}
+
+	if(status != NULL) *status = child_process->codigo_salida;
+
+	/* El zombi se libera ya; el que está terminando, cuando se recoja */
+	if(child_process->estado == ZOMBI)
+		soltar_zombi(child_process, waiting_process);
+	else
+		child_process->padre = -1;
+
+	fijar_nivel_int(interruption_level);
+	return 0;
+}
+
+/*
+ *	Fijar prioridad: cambia la prioridad estática del proceso actual
+ *	y devuelve la anterior
+ */
+int fijar_prioridad(unsigned int prioridad){
+
+	unsigned int new_priority = (unsigned int)leer_registro(1);
+	int previous_priority;
+
+	if(new_priority >= NUM_PRIORIDADES){
+		printk("Prioridad %u fuera de rango.\n", new_priority);
+		return -1;
+	}
+
+	int interruption_level = fijar_nivel_int(NIVEL_3);
+
+	/* El proceso actual está en su cola de listos: se cambia de cola */
+	previous_priority = p_proc_actual->priority;
+	ready_remove(p_proc_actual);
+	p_proc_actual->priority = new_priority;
+	ready_insert(p_proc_actual);
+
+	/* Si ahora hay alguien más prioritario se cede el procesador */
+	if(ready_preempt(p_proc_actual)) activar_int_SW();
+
+	fijar_nivel_int(interruption_level);
+	return previous_priority;
+}
+
+/*
+ *	Obtener prioridad: devuelve la prioridad estática del proceso actual
+ */
+int obtener_prioridad(){
+	return p_proc_actual->priority;
+}
+
+/*
+ *	Fijar tickets: cambia los tickets del proceso actual para las
+ *	políticas proporcionales y devuelve los anteriores
+ */
+int fijar_tickets(unsigned int tickets){
+
+	unsigned int new_tickets = (unsigned int)leer_registro(1);
+	int previous_tickets;
+
+	if(new_tickets == 0 || new_tickets > MAX_TICKETS){
+		printk("Número de tickets %u fuera de rango.\n", new_tickets);
+		return -1;
+	}
+
+	int interruption_level = fijar_nivel_int(NIVEL_3);
+
+	/* El proceso actual está en la estructura de listos: se reinserta
+		para que cuente con los nuevos tickets */
+	previous_tickets = p_proc_actual->tickets;
+	ready_remove(p_proc_actual);
+	total_tickets += new_tickets - previous_tickets;
+	p_proc_actual->tickets = new_tickets;
+	ready_insert(p_proc_actual);
+
+	fijar_nivel_int(interruption_level);
+	return previous_tickets;
+}
+
+/*
+ *	Obtener reparto: devuelve en tanto por mil la fracción de UCP que ha
+ *	recibido el proceso actual desde su creación y la que le corresponde
+ *	según sus tickets y los de los procesos vivos
+ */
+int obtener_reparto(unsigned int *real, unsigned int *objetivo){
+
+	unsigned int *real_share = (unsigned int *)leer_registro(1);
+	unsigned int *target_share = (unsigned int *)leer_registro(2);
+	unsigned long long elapsed = ticks_ocupados - p_proc_actual->ticks_inicio;
+
+	*real_share = elapsed ? (p_proc_actual->ticks_cpu * 1000) / elapsed : 0;
+	*target_share = (p_proc_actual->tickets * 1000) / total_tickets;
+
+	printk("Proceso %d: %llu TICKs de UCP, reparto real %u/1000, objetivo %u/1000\n",
+		p_proc_actual->id, p_proc_actual->ticks_cpu, *real_share, *target_share);
+	return 0;
+}
+
+/*
+ *	Fijar tiempo real: el proceso actual pasa a la clase EDF con el
+ *	periodo, presupuesto y plazo relativo indicados en TICKs (plazo 0
+ *	equivale al periodo). Se rechaza si la utilización total de la clase
+ *	superaría RT_UTIL_MAX. Con periodo 0 el proceso vuelve a la
+ *	política normal.
+ */
+int fijar_tiempo_real(unsigned int periodo, unsigned int presupuesto, unsigned int plazo){
+
+	unsigned int period = (unsigned int)leer_registro(1);
+	unsigned int budget = (unsigned int)leer_registro(2);
+	unsigned int deadline = (unsigned int)leer_registro(3);
+	unsigned int utilization = 0;
+
+	if(deadline == 0) deadline = period;
+
+	if(period != 0){
+		if(budget == 0 || budget > deadline || deadline > period){
+			printk("Parámetros de tiempo real no válidos.\n");
+			return -1;
+		}
+		utilization = edf_utilization(budget, deadline);
+	}
+
+	int interruption_level = fijar_nivel_int(NIVEL_3);
+
+	/* Prueba de admisión: la suma de utilizaciones no debe superar el
+		límite, descontando la que ya tuviera el propio proceso */
+	if(rt_utilization - p_proc_actual->rt_util + utilization > RT_UTIL_MAX){
+		printk("Proceso %d rechazado: utilización de tiempo real %u/1000 superaría %d/1000.\n",
+			p_proc_actual->id, rt_utilization - p_proc_actual->rt_util + utilization, RT_UTIL_MAX);
+		fijar_nivel_int(interruption_level);
+		return -1;
+	}
+
+	/* El proceso actual sale de la estructura de listos de su clase
+		y entra en la de la nueva; lo prestado solo le hace pasar por
+		delante en la clase normal */
+	donados_quitar(p_proc_actual);
+	ready_remove(p_proc_actual);
+	rt_utilization += utilization - p_proc_actual->rt_util;
+	p_proc_actual->rt_util = utilization;
+	p_proc_actual->rt_period = period;
+
+	if(period != 0){
+		p_proc_actual->rt_budget = budget;
+		p_proc_actual->rt_deadline = deadline;
+		p_proc_actual->rt_release = ticks_sistema;
+		edf_new_job(p_proc_actual);
+	}
+	else{
+		planif->init(p_proc_actual);
+	}
+	ready_insert(p_proc_actual);
+	donados_poner(p_proc_actual);
+
+	if(ready_preempt(p_proc_actual)) activar_int_SW();
+
+	fijar_nivel_int(interruption_level);
+	return 0;
+}
+
+/*
+ *	Esperar periodo: el proceso de tiempo real da por terminado el trabajo
+ *	actual y se bloquea hasta el comienzo del siguiente periodo. Devuelve
+ *	el número de plazos que ha incumplido hasta ahora.
+ */
+int esperar_periodo(){
+
+	BCPptr actual_process = p_proc_actual;
+
+	if(actual_process->rt_period == 0){
+		printk("El proceso %d no es de tiempo real.\n", actual_process->id);
+		return -1;
+	}
+
+	int interruption_level = fijar_nivel_int(NIVEL_3);
+
+	edf_check_deadline(actual_process);
+	actual_process->rt_job_done = 1;
+	actual_process->estado = BLOQUEADO;
+
+	ready_block(actual_process);
+	insertar_ultimo(&lista_rt_espera, actual_process);
+
+	p_proc_actual = planificador();
+
+	fijar_nivel_int(interruption_level);
+
+	cambio_contexto(&(actual_process->contexto_regs), &(p_proc_actual->contexto_regs));
+
+	return actual_process->rt_misses;
+}
+
+/*
+ *	Obtener rodaja: devuelve la rodaja actual del proceso en TICKs y
+ *	copia en historia sus últimas QUANTUM_HIST rodajas, de la más antigua
+ *	a la más reciente (0 en las posiciones aún sin usar)
+ */
+int obtener_rodaja(unsigned int *historia){
+
+	unsigned int *history = (unsigned int *)leer_registro(1);
+
+	for(int i = 0; i < QUANTUM_HIST; i++){
+		history[i] = p_proc_actual->quantum_hist[(p_proc_actual->quantum_hist_pos + i) % QUANTUM_HIST];
+	}
+	return p_proc_actual->quantum;
+}
+
+/*
+ *	Ceder procesador: el proceso actual vuelve a listos por el mismo
+ *	camino que un cambio de contexto involuntario
+ */
+int ceder_procesador(){
+
+	printk("-> PROC %d: CEDE LA UCP\n", p_proc_actual->id);
+
+	robin_process_change();
+
+	return 0;
+}
+
+/*
+ *	Ceder a: el proceso actual cede la UCP y lo que le queda de rodaja al
+ *	proceso listo pid, que pasa a ejecutarse directamente. La rodaja se
+ *	traspasa: el que cede vuelve a listos como si la hubiera agotado. Si
+ *	hay procesos de tiempo real listos, estos conservan la preferencia.
+ */
+int ceder_a(int pid){
+
+	int target_pid = (int)leer_registro(1);
+
+	int interruption_level = fijar_nivel_int(NIVEL_3);
+
+	BCPptr actual_process = p_proc_actual;
+	BCPptr target_process = buscar_BCP(target_pid);
+
+	/* Solo puede recibir la UCP un proceso listo de la clase normal */
+	if(target_process == NULL || target_process->estado != LISTO ||
+		target_process->rt_period != 0){
+		fijar_nivel_int(interruption_level);
+		return -1;
+	}
+
+	printk("-> PROC %d: CEDE SU RODAJA A %d\n", actual_process->id, target_pid);
+
+	/* La rodaja que le quedaba pasa al proceso destino, sin superar
+		RODAJA_MAX, y el que cede se queda sin ella. Lo que le hayan
+		prestado los que esperan sus mutex no es suyo y lo conserva. */
+	if(actual_process->robin_seconds > 0)
+		target_process->robin_seconds += actual_process->robin_seconds;
+	if(target_process->robin_seconds > RODAJA_MAX)
+		target_process->robin_seconds = RODAJA_MAX;
+	actual_process->robin_seconds = 0;
+
+	ready_expire(actual_process);
+
+	p_proc_actual = planificar_hacia(target_process);
+
+	fijar_nivel_int(interruption_level);
+
+	cambio_contexto(&(actual_process->contexto_regs), &(p_proc_actual->contexto_regs));
+
+	return 0;
+}
+
+/*
+ *	Crear grupo: crea un grupo que puede consumir cuota TICKs de UCP por
+ *	cada periodo, mete en él al proceso actual y devuelve su número. Los
+ *	procesos que cree a partir de ese momento heredan el grupo. Solo se
+ *	puede llamar desde el grupo 0: un proceso con cuota no puede librarse
+ *	de ella creando otro grupo.
+ */
+int crear_grupo(unsigned int cuota, unsigned int periodo){
+
+	unsigned int quota = (unsigned int)leer_registro(1);
+	unsigned int period = (unsigned int)leer_registro(2);
+
+	if(period == 0 || quota == 0 || quota > period){
+		printk("Cuota %d/%d no válida.\n", quota, period);
+		return -1;
+	}
+
+	if(p_proc_actual->grupo != 0){
+		printk("El proceso %d ya pertenece al grupo %d.\n", p_proc_actual->id, p_proc_actual->grupo);
+		return -1;
+	}
+
+	int interruption_level = fijar_nivel_int(NIVEL_3);
+
+	/* El grupo 0 no se asigna nunca */
+	int group_id;
+	for(group_id = 1; group_id < MAX_GRUPOS; group_id++){
+		if(tabla_grupos[group_id].num_procs == 0) break;
+	}
+	if(group_id == MAX_GRUPOS){
+		fijar_nivel_int(interruption_level);
+		printk("No quedan grupos libres.\n");
+		return -1;
+	}
+
+	grupo *new_group = &tabla_grupos[group_id];
+	new_group->cuota = quota;
+	new_group->periodo = period;
+	new_group->inicio_periodo = ticks_sistema;
+	new_group->consumo = 0;
+	new_group->estrangulado = 0;
+	new_group->ticks_total = 0;
+	new_group->estrangulamientos = 0;
+	iniciar_lista(&new_group->espera, ENLACE_LISTOS);
+	iniciar_lista(&new_group->miembros, ENLACE_GRUPO);
+
+	/* El proceso actual deja su grupo y pasa al nuevo */
+	grupo_salir(p_proc_actual);
+	grupo_entrar(p_proc_actual, group_id);
+	grupos_con_cuota++;
+
+	fijar_nivel_int(interruption_level);
+
+	printk("-> PROC %d CREA EL GRUPO %d CON CUOTA %d/%d\n", p_proc_actual->id, group_id, quota, period);
+	return group_id;
+}
+
+/*
+ *	Obtener uso de grupo: devuelve en consumo los TICKs de UCP que ha
+ *	consumido el grupo desde su creación y en estrangulamientos los
+ *	periodos en que agotó su cuota
+ */
+int obtener_uso_grupo(unsigned int num_grupo, unsigned int *consumo, unsigned int *estrangulamientos){
+
+	unsigned int group_id = (unsigned int)leer_registro(1);
+	unsigned int *used_ticks = (unsigned int *)leer_registro(2);
+	unsigned int *throttles = (unsigned int *)leer_registro(3);
+
+	if(group_id >= MAX_GRUPOS || (group_id != 0 && tabla_grupos[group_id].num_procs == 0)){
+		printk("El grupo %d no existe.\n", group_id);
+		return -1;
+	}
+
+	*used_ticks = tabla_grupos[group_id].ticks_total;
+	*throttles = tabla_grupos[group_id].estrangulamientos;
+	return 0;
+}
+
+/*
+ *	Obtener coste de dormir: devuelve el número de procesos dormidos y,
+ *	desde el arranque, los TICKs tratados, los procesos que la rueda ha
+ *	movido o despertado y los que habría recorrido una lista de dormidos
+ */
+int obtener_coste_dormir(unsigned int *ticks, unsigned int *visitas, unsigned int *lineal){
+
+	unsigned int *treated_ticks = (unsigned int *)leer_registro(1);
+	unsigned int *visited = (unsigned int *)leer_registro(2);
+	unsigned int *linear = (unsigned int *)leer_registro(3);
+
+	*treated_ticks = rueda_ticks;
+	*visited = rueda_visitas;
+	*linear = rueda_lineal;
+	return num_dormidos;
+}
+
+/*
+ *	Bloquea al proceso actual en la rueda de temporización hasta el TICK
+ *	indicado y devuelve el TICK en que despierta
+ */
+static unsigned long long dormir_proceso(unsigned long long despertar){
+
+	/*	Guardado del nivel de interrupción	*/
+	int interruption_level = fijar_nivel_int(NIVEL_3);
+
+	/* Guardado del proceso actual que quiere bloquearse	*/
+	BCPptr actual_process = p_proc_actual;
+
+	/*	Actualización del estado del proceso en el BCP	*/
+	actual_process->estado = BLOQUEADO;
+
+	/* Intercambio del proceso entre lista_listos y la rueda de temporización */
+	ready_block(actual_process);
+	rueda_dormir(actual_process, despertar);
+
+	/* Un despertar cercano exige la frecuencia de reloj normal */
+	reloj_ajustar();
+
+	/* Llamada al planificador que devuelve nuevo proceso en ejecución */
+	p_proc_actual = planificador();
+
+	/* Restauración del nivel de interrupción */
+	fijar_nivel_int(interruption_level);
+
+	/* Cambio de contexto entre el nuevo proceso a ejecutar y el proceso bloqueado */
+	cambio_contexto(&(actual_process->contexto_regs), &(p_proc_actual->contexto_regs));
+
+	return ticks_sistema;
+}
+
+/*
+ *	Fijar holgura: fija los TICKs que puede retrasarse el despertar del
+ *	proceso actual para agruparlo con otros y devuelve la anterior
+ */
+int fijar_holgura(unsigned int holgura){
+
+	unsigned int slack = (unsigned int)leer_registro(1);
+	unsigned int old_slack = p_proc_actual->holgura;
+
+	p_proc_actual->holgura = slack;
+	return old_slack;
+}
+
+/*
+ *	Obtener agrupamiento: devuelve los despertares que la holgura ha
+ *	agrupado en un TICK compartido y las pasadas del planificador ahorradas
+ */
+int obtener_agrupamiento(unsigned int *agrupados, unsigned int *ahorradas){
+
+	unsigned int *coalesced = (unsigned int *)leer_registro(1);
+	unsigned int *saved = (unsigned int *)leer_registro(2);
+
+	*coalesced = despertares_agrupados;
+	*saved = planificaciones_ahorradas;
+	return 0;
+}
+
+/*
+ *	Obtener ahorro de reloj: devuelve las interrupciones de reloj evitadas
+ *	por la frecuencia dinámica y las tratadas por el camino rápido, y la
+ *	frecuencia actual en interrupciones por segundo
+ */
+int obtener_ahorro_reloj(unsigned int *evitadas, unsigned int *tranquilos){
+
+	unsigned int *avoided = (unsigned int *)leer_registro(1);
+	unsigned int *quiet = (unsigned int *)leer_registro(2);
+
+	*avoided = interrupciones_evitadas;
+	*quiet = ticks_tranquilos;
+	return TICK / ticks_por_int;
+}
+
+/*
+ *	Fijar reserva de pilas: cambia el máximo de pilas que se guardan (0 la
+ *	desactiva), libera las que sobran y pone a cero las estadísticas.
+ *	Devuelve el máximo anterior.
+ */
+int fijar_reserva_pilas(unsigned int maximo){
+
+	unsigned int max_stacks = (unsigned int)leer_registro(1);
+	int previous = max_pilas_reserva;
+
+	if(max_stacks > RESERVA_PILAS_TOPE){
+		printk("Máximo de la reserva de pilas no válido.\n");
+		return -1;
+	}
+
+	max_pilas_reserva = max_stacks;
+	recortar_reserva_pilas();
+
+	pilas_aciertos = 0;
+	pilas_fallos = 0;
+	num_arranques = 0;
+	arranque_total_ns = 0;
+	return previous;
+}
+
+/*
+ *	Obtener reserva de pilas: devuelve las creaciones que han encontrado
+ *	pila en la reserva y las que no, y el tiempo medio desde que empieza la
+ *	creación de un proceso hasta su primera llamada al sistema. Devuelve
+ *	las pilas guardadas.
+ */
+int obtener_reserva_pilas(unsigned int *aciertos, unsigned int *fallos, unsigned int *arranque_ns){
+
+	unsigned int *hits = (unsigned int *)leer_registro(1);
+	unsigned int *misses = (unsigned int *)leer_registro(2);
+	unsigned int *startup = (unsigned int *)leer_registro(3);
+
+	*hits = pilas_aciertos;
+	*misses = pilas_fallos;
+	*startup = num_arranques ? arranque_total_ns / num_arranques : 0;
+	return num_pilas_reserva;
+}
+
+/*
+ *	Fijar caché de imágenes: cambia el máximo de imágenes sin procesos que
+ *	se conservan (0 desactiva la caché), desaloja las que sobran y pone a
+ *	cero las estadísticas. Devuelve el máximo anterior.
+ */
+int fijar_cache_imagenes(unsigned int maximo){
+
+	unsigned int max_images = (unsigned int)leer_registro(1);
+	int previous = max_imagenes_libres;
+
+	if(max_images > TABLA_IMAGENES){
+		printk("Máximo de la caché de imágenes no válido.\n");
+		return -1;
+	}
+
+	max_imagenes_libres = max_images;
+	recortar_cache_imagenes();
+
+	imagenes_aciertos = 0;
+	imagenes_fallos = 0;
+	imagenes_desalojos = 0;
+	imagenes_carga_ns = 0;
+	return previous;
+}
+
+/*
+ *	Obtener caché de imágenes: devuelve las creaciones que han encontrado
+ *	la imagen en la caché y las que han tenido que cargarla, y el tiempo
+ *	medio de carga. Devuelve las imágenes guardadas.
+ */
+int obtener_cache_imagenes(unsigned int *aciertos, unsigned int *fallos, unsigned int *carga_ns){
+
+	unsigned int *hits = (unsigned int *)leer_registro(1);
+	unsigned int *misses = (unsigned int *)leer_registro(2);
+	unsigned int *load_time = (unsigned int *)leer_registro(3);
+	int cached = 0;
+
+	for(int i = 0; i < TABLA_IMAGENES; i++){
+		if(tabla_imagenes[i].nombre[0] != '\0') cached++;
+	}
+
+	*hits = imagenes_aciertos;
+	*misses = imagenes_fallos;
+	*load_time = imagenes_fallos ? imagenes_carga_ns / imagenes_fallos : 0;
+	return cached;
 }
 
 /*
- * Tratamiento de interrupciuones software
+ *	Obtener recogida: devuelve el tiempo medio desde que un proceso
+ *	termina hasta que ejecuta el siguiente y el tiempo medio de liberar
+ *	los recursos de cada terminado desde la consulta anterior, y pone a
+ *	cero las estadísticas. Devuelve los procesos liberados.
  */
-static void int_sw(){
+int obtener_recogida(unsigned int *fin_ns, unsigned int *recogida_ns){
 
-	printk("-> TRATANDO INT. SW\n");
+	unsigned int *exit_time = (unsigned int *)leer_registro(1);
+	unsigned int *reap_time = (unsigned int *)leer_registro(2);
+	int reaped;
 
-	robin_process_change();
+	*exit_time = num_fines ? fin_total_ns / num_fines : 0;
+	*reap_time = num_recogidos ? recogida_total_ns / num_recogidos : 0;
+	reaped = num_recogidos;
 
-	return;
+	num_fines = 0;
+	fin_total_ns = 0;
+	num_recogidos = 0;
+	recogida_total_ns = 0;
+	return reaped;
 }
 
 /*
- *
- * Funcion auxiliar que crea un proceso reservando sus recursos.
- * Usada por llamada crear_proceso.
- *
+ *	Fijar carga diferida: la activa o la desactiva para los procesos que
+ *	se creen a partir de ahora y pone a cero sus estadísticas. Devuelve el
+ *	modo anterior.
  */
-static int crear_tarea(char *prog){
-	void * imagen, *pc_inicial;
-	int error=0;
-	int proc;
-	BCP *p_proc;
+int fijar_carga_diferida(unsigned int activa){
 
-	proc=buscar_BCP_libre();
-	if (proc==-1)
-		return -1;	/* no hay entrada libre */
-
-	/* A rellenar el BCP ... */
-	p_proc=&(tabla_procs[proc]);
-
-	/* crea la imagen de memoria leyendo ejecutable */
-	imagen=crear_imagen(prog, &pc_inicial);
-	if (imagen)
-	{
-		p_proc->info_mem=imagen;
-		p_proc->pila=crear_pila(TAM_PILA);
-		fijar_contexto_ini(p_proc->info_mem, p_proc->pila, TAM_PILA,
-			pc_inicial,
-			&(p_proc->contexto_regs));
-		p_proc->id=proc;
-		p_proc->estado=LISTO;
-
-		/* A la hora de crear el proceso deben establecerse el número de TICKS
-			de round robin que debe estar ejecutándose */
-		p_proc->robin_seconds = TICKS_POR_RODAJA;
-
-		/* lo inserta al final de cola de listos */
-		insertar_ultimo(&lista_listos, p_proc);
-		error= 0;
-	}
-	else
-		error= -1; /* fallo al crear imagen */
+	unsigned int active = (unsigned int)leer_registro(1);
+	int previous = carga_diferida;
+
+	carga_diferida = (active != 0);
 
-	return error;
+	num_creados = 0;
+	creacion_total_ns = 0;
+	cargas_diferidas = 0;
+	carga_diferida_ns = 0;
+	return previous;
 }
 
 /*
- *
- * Rutinas que llevan a cabo las llamadas al sistema
- *	sis_crear_proceso sis_escribir
- *
+ *	Obtener carga diferida: devuelve el tiempo medio que tarda en volver
+ *	la creación de cada proceso y el tiempo medio de cada carga diferida.
+ *	Devuelve las cargas diferidas realizadas.
  */
+int obtener_carga_diferida(unsigned int *creacion_ns, unsigned int *carga_ns){
 
-/*
- * Tratamiento de llamada al sistema crear_proceso. Llama a la
- * funcion auxiliar crear_tarea sis_terminar_proceso
- */
-int sis_crear_proceso(){
-	char *prog;
-	int res;
+	unsigned int *creation_time = (unsigned int *)leer_registro(1);
+	unsigned int *load_time = (unsigned int *)leer_registro(2);
 
-	printk("-> PROC %d: CREAR PROCESO\n", p_proc_actual->id);
-	prog=(char *)leer_registro(1);
-	res=crear_tarea(prog);
-	return res;
+	*creation_time = num_creados ? creacion_total_ns / num_creados : 0;
+	*load_time = cargas_diferidas ? carga_diferida_ns / cargas_diferidas : 0;
+	return cargas_diferidas;
 }
 
 /*
- * Tratamiento de llamada al sistema escribir. Llama simplemente a la
- * funcion de apoyo escribir_ker
+ *	Obtener nombres de mutex: devuelve las búsquedas de nombres de mutex
+ *	desde la consulta anterior y su tiempo medio, y las pone a cero.
+ *	Devuelve el número de mutex del sistema.
  */
-int sis_escribir()
-{
-	char *texto;
-	unsigned int longi;
+int obtener_nombres_mutex(unsigned int *busquedas, unsigned int *busqueda_ns){
 
-	texto=(char *)leer_registro(1);
-	longi=(unsigned int)leer_registro(2);
+	unsigned int *lookups = (unsigned int *)leer_registro(1);
+	unsigned int *lookup_time = (unsigned int *)leer_registro(2);
 
-	escribir_ker(texto, longi);
-	return 0;
+	*lookups = busquedas_mutex;
+	*lookup_time = busquedas_mutex ? busqueda_mutex_ns / busquedas_mutex : 0;
+
+	busquedas_mutex = 0;
+	busqueda_mutex_ns = 0;
+	return num_mutex;
 }
 
 /*
- * Tratamiento de llamada al sistema terminar_proceso. Llama a la
- * funcion auxiliar liberar_proceso
+ *	Fijar donación: activa o desactiva el préstamo de rodaja a los dueños
+ *	de mutex, pone a cero sus estadísticas y devuelve el modo anterior.
+ *	Lo ya prestado se consume o se retira como siempre.
  */
-int sis_terminar_proceso(){
+int fijar_donacion(unsigned int activa){
 
-	printk("-> FIN PROCESO %d\n", p_proc_actual->id);
+	unsigned int active = (unsigned int)leer_registro(1);
+	int previous = donacion_activa;
 
-	liberar_proceso();
+	donacion_activa = (active != 0);
 
-        return 0; /* no deber�a llegar aqui */
+	donaciones = 0;
+	ticks_prestados = 0;
+	ticks_adelantados = 0;
+	ticks_devueltos = 0;
+	return previous;
 }
 
-int obtener_id_pr(){
-	int id = p_proc_actual->id;
-	printk("ID del proceso actual es: %d\n", id);
-	return id;
+/*
+ *	Obtener donación: devuelve los TICKs prestados a dueños de mutex desde
+ *	fijar_donacion, cuántos de ellos han consumido y cuántos han vuelto sin
+ *	consumir a los que los prestaron, y la rodaja propia
+ *	que le queda al proceso actual y, aparte, lo prestado que aún no ha
+ *	consumido. Devuelve el número de préstamos.
+ */
+int obtener_donacion(unsigned int *prestados, unsigned int *adelantados, unsigned int *devueltos, int *rodaja, int *pendiente){
+
+	unsigned int *lent = (unsigned int *)leer_registro(1);
+	unsigned int *consumed = (unsigned int *)leer_registro(2);
+	unsigned int *returned = (unsigned int *)leer_registro(3);
+	int *slice = (int *)leer_registro(4);
+	int *pending = (int *)leer_registro(5);
+
+	*lent = ticks_prestados;
+	*consumed = ticks_adelantados;
+	*returned = ticks_devueltos;
+	*slice = p_proc_actual->robin_seconds;
+	*pending = p_proc_actual->donacion;
+	return donaciones;
 }
 
 /*
@@ -374,33 +3063,98 @@ int dormir(unsigned int seconds){
 		que debe bloquearse el proceso	*/
 	unsigned int sleeping_seconds = (unsigned int)leer_registro(1);
 
-	/*	Guardado del nivel de interrupción	*/
-	int interruption_level = fijar_nivel_int(NIVEL_3);
+	/* El TICK en que debe despertar se ajusta a la velocidad del reloj */
+	dormir_proceso(ticks_sistema + (unsigned long long)sleeping_seconds*TICK);
 
-	/* Guardado del proceso actual que quiere bloquearse	*/
-	BCPptr actual_process = p_proc_actual;
+	return 1;
+}
 
-	/*	Actualización del estado del proceso en el BCP	*/
-	actual_process->estado = BLOQUEADO;
+/*
+ *	Dormir ticks: bloquea al proceso el número de TICKs indicado (al menos
+ *	hasta el siguiente) y devuelve el TICK en que despierta
+ */
+int dormir_ticks(unsigned int ticks){
 
-	/* Actualización del número de segundos que debe dormir el proceso ajustado
-		a la velocidad del reloj */
-	actual_process->seconds = sleeping_seconds*TICK;
+	unsigned int sleeping_ticks = (unsigned int)leer_registro(1);
 
-	/* Intercambio del proceso entre lista_listos y lista_bloqueados */
-	eliminar_elem(&lista_listos, actual_process);
-	insertar_ultimo(&lista_bloqueados, actual_process);
+	return dormir_proceso(ticks_sistema + sleeping_ticks);
+}
 
-	/* Llamada al planificador que devuelve nuevo proceso en ejecución */
-	p_proc_actual = planificador();
+/*
+ *	Dormir hasta: bloquea al proceso hasta el TICK absoluto indicado y
+ *	devuelve el TICK en que despierta. Si ese TICK ya ha pasado vuelve
+ *	sin bloquearse, por lo que dormir_hasta(0) devuelve el TICK actual.
+ */
+int dormir_hasta(unsigned int tick){
 
-	/* Restauración del nivel de interrupción */
-	fijar_nivel_int(interruption_level);
+	unsigned int wakeup_tick = (unsigned int)leer_registro(1);
 
-	/* Cambio de contexto entre el nuevo proceso a ejecutar y el proceso bloqueado */
-	cambio_contexto(&(actual_process->contexto_regs), &(p_proc_actual->contexto_regs));
+	if(wakeup_tick <= ticks_sistema) return ticks_sistema;
 
-	return 1;
+	return dormir_proceso(wakeup_tick);
+}
+
+/*
+ *	Crear temporizador: crea un temporizador periódico que vence cada
+ *	periodo TICKs a partir del actual y devuelve su descriptor. Se libera
+ *	al terminar el proceso que lo crea.
+ */
+int crear_temporizador(unsigned int periodo){
+
+	unsigned int period = (unsigned int)leer_registro(1);
+
+	if(period == 0){
+		printk("Periodo de temporizador no válido.\n");
+		return -1;
+	}
+
+	for(int i = 0; i < MAX_TEMPORIZADORES; i++){
+		temporizador *periodic_timer = &tabla_temporizadores[i];
+		if(periodic_timer->propietario == NULL){
+			periodic_timer->propietario = p_proc_actual;
+			periodic_timer->periodo = period;
+			periodic_timer->siguiente = ticks_sistema + period;
+			periodic_timer->perdidos = 0;
+			return i;
+		}
+	}
+
+	printk("No quedan temporizadores libres.\n");
+	return -1;
+}
+
+/*
+ *	Esperar temporizador: bloquea al proceso hasta el siguiente vencimiento
+ *	del temporizador. Los vencimientos se calculan siempre desde el de
+ *	creación, de forma que la cadencia no deriva aunque el proceso se
+ *	retrase. Devuelve el número de periodos perdidos desde la última espera.
+ */
+int esperar_temporizador(int num_temporizador){
+
+	int timer_id = (int)leer_registro(1);
+
+	if(timer_id < 0 || timer_id >= MAX_TEMPORIZADORES ||
+		tabla_temporizadores[timer_id].propietario != p_proc_actual){
+		printk("El temporizador %d no es del proceso %d.\n", timer_id, p_proc_actual->id);
+		return -1;
+	}
+
+	temporizador *periodic_timer = &tabla_temporizadores[timer_id];
+	unsigned int missed = 0;
+
+	if(ticks_sistema < periodic_timer->siguiente){
+		/* Vencimiento a tiempo: se espera a él */
+		dormir_proceso(periodic_timer->siguiente);
+	}
+	else{
+		/* Ya ha vencido: cuenta los periodos completos que se han perdido */
+		missed = (ticks_sistema - periodic_timer->siguiente) / periodic_timer->periodo;
+		periodic_timer->perdidos += missed;
+		periodic_timer->siguiente += (unsigned long long)missed * periodic_timer->periodo;
+	}
+	periodic_timer->siguiente += periodic_timer->periodo;
+
+	return missed;
 }
 
 void process_unlock(BCPptr sleeping_process){
@@ -408,12 +3162,9 @@ void process_unlock(BCPptr sleeping_process){
 	/* Guardado del nivel de interrupción y cambio a nivel 3 */
 	int interruption_level = fijar_nivel_int(NIVEL_3);
 
-	/* Cambio de estado del proceso desbloqueado */
-	sleeping_process->estado = LISTO;
-
-	/* Intercambio del proceso entre lista bloqueados y lista listos */
-	eliminar_elem(&lista_bloqueados, sleeping_process);
-	insertar_ultimo(&lista_listos, sleeping_process);	
+	/* El proceso, ya fuera de la rueda, vuelve a la lista de listos,
+		que además cambia su estado */
+	ready_wakeup(sleeping_process);
 
 	/* Restauración del nivel de interrupción */
 	fijar_nivel_int(interruption_level);
@@ -422,117 +3173,363 @@ void process_unlock(BCPptr sleeping_process){
 
 void timer(){
 
-	/* Puntero que apunta al primer proceso de la lista_bloqueados */
-	BCPptr sleeping_process = lista_bloqueados.primero;
-
-	/* Bucle que recorre la lista de procesos bloqueados hasta el final */
-	while(sleeping_process != NULL){
+	BCPptr sleeping_process;
+	int nivel, ranura, lote, retrasados;
 
-		BCPptr siguiente = sleeping_process->siguiente;
+	/* La rueda avanza TICK a TICK hasta alcanzar el del sistema */
+	while(rueda_ahora < ticks_sistema){
 
-		/* Reducción de el tiempo que el proceso debe permanecer bloqueado */
-		sleeping_process->seconds--;
-		printk("Proceso id %d restan %d TICKs de reloj para despertar.\n",sleeping_process->id, sleeping_process->seconds);
+		rueda_ahora++;
+		rueda_ticks++;
+		rueda_lineal += num_dormidos;
 
-		/* Comprobación de que el proceso debe dejar de estar bloqueado */
-		if(sleeping_process->seconds <= 0){
+		/* Al completar una vuelta de un nivel se baja la ranura siguiente
+			del nivel superior */
+		ranura = rueda_ahora & RUEDA_MASCARA;
+		for(nivel = 1; ranura == 0 && nivel < RUEDA_NIVELES; nivel++){
+			ranura = rueda_cascada(nivel);
+		}
 
-			/* Llamada a la función de desbloqueo */
+		/* Todos los procesos de la ranura actual del nivel 0 despiertan
+			en este TICK como un lote, en el orden en que se durmieron */
+		ranura = rueda_ahora & RUEDA_MASCARA;
+		mapa_rueda[0] &= ~(1ULL << ranura);
+		lote = 0;
+		retrasados = 0;
+		while((sleeping_process = rueda[0][ranura].primero) != NULL){
+			eliminar_primero(&rueda[0][ranura]);
+			num_dormidos--;
+			rueda_visitas++;
+			lote++;
+			if(sleeping_process->despertar != sleeping_process->despertar_pedido) retrasados++;
+			printk("Proceso id %d despierta.\n", sleeping_process->id);
 			process_unlock(sleeping_process);
 		}
 
-		/* Avance del puntero hacia el siguiente proceso bloqueado */
-		sleeping_process = siguiente;
+		/* Cada proceso retrasado por su holgura hasta un TICK compartido
+			se ahorra una pasada del planificador propia */
+		if(lote > 1){
+			despertares_agrupados += retrasados;
+			planificaciones_ahorradas += (retrasados < lote - 1) ? retrasados : lote - 1;
+		}
 	}
 	return;
 }
 
+/*
+ *
+ * Funciones de la tabla de descriptores de los procesos
+ *	reservar_descriptor abrir_descriptor buscar_descriptor
+ *	liberar_descriptor
+ *
+ * Un descriptor es el índice de su entrada en la tabla del proceso, así
+ * que se consulta de forma directa. Las entradas libres forman una cadena
+ * para asignarlas en tiempo constante y, si no queda ninguna, la tabla
+ * dobla su tamaño hasta DESCRIPTORES_TOPE. Cada entrada indica el tipo de
+ * objeto al que apunta, de modo que sirve para cualquier objeto del
+ * núcleo.
+ *
+ */
+
+/*
+ * Asegura que el proceso tiene una entrada libre, ampliando su tabla si
+ * hace falta, y la devuelve sin ocuparla; -1 si ha llegado al máximo
+ */
+static int reservar_descriptor(BCP *proc){
+	int i, num;
+	descriptor *nueva;
+
+	if (proc->descriptor_libre!=-1)
+		return proc->descriptor_libre;
+
+	num=proc->num_descriptores ? proc->num_descriptores*2 : NUM_MUT_PROC;
+	if (num>DESCRIPTORES_TOPE)
+		return -1;
+	nueva=realloc(proc->descriptores, num*sizeof(descriptor));
+	if (nueva==NULL)
+		return -1;
+
+	/* Las nuevas entradas se encadenan en orden */
+	for (i=num-1; i>=proc->num_descriptores; i--) {
+		nueva[i].tipo=DESC_LIBRE;
+		nueva[i].objeto=proc->descriptor_libre;
+		proc->descriptor_libre=i;
+	}
+	proc->descriptores=nueva;
+	proc->num_descriptores=num;
+	return proc->descriptor_libre;
+}
+
+/*
+ * Ocupa una entrada libre con el objeto indicado y devuelve su descriptor,
+ * o -1 si no hay ninguna
+ */
+static int abrir_descriptor(BCP *proc, int tipo, int objeto){
+	int desc=reservar_descriptor(proc);
+
+	if (desc==-1)
+		return -1;
+	proc->descriptor_libre=proc->descriptores[desc].objeto;
+	proc->descriptores[desc].tipo=tipo;
+	proc->descriptores[desc].objeto=objeto;
+	return desc;
+}
+
+/*
+ * Devuelve el objeto al que apunta el descriptor si es del tipo indicado,
+ * o -1
+ */
+static int buscar_descriptor(BCP *proc, unsigned int desc, int tipo){
+	if (desc>=(unsigned int)proc->num_descriptores ||
+	    proc->descriptores[desc].tipo!=tipo)
+		return -1;
+	return proc->descriptores[desc].objeto;
+}
+
+/*
+ * Devuelve el descriptor a la cadena de libres
+ */
+static void liberar_descriptor(BCP *proc, int desc){
+	proc->descriptores[desc].tipo=DESC_LIBRE;
+	proc->descriptores[desc].objeto=proc->descriptor_libre;
+	proc->descriptor_libre=desc;
+}
+
 /*
  *
  *	Funciones relacionadas con el tratamiento de mutex
  *
+ *	Los nombres se buscan en un índice por resumen con encadenamiento,
+ *	de modo que crear, abrir y cerrar hacen una sola búsqueda de coste
+ *	constante en vez de recorrer toda la lista de mutex. Las entradas
+ *	libres forman una cadena aparte.
+ *
  */
 
-/* Función que revisa que el nombre introducido al nuevo mutex no se encuentra actualmente en uso */
-int mutex_name_taken(char *mutex_name){
+/* Reserva la lista de mutex con el tamaño que indique la variable de
+	entorno MAX_MUTEX_ENV y un índice con al menos el doble de cubetas */
+static void iniciar_mutex(){
 
-	/* Recorrido de la lista de mutex*/
-	for(int i = 0; i < NUM_MUT; i++){
-		/* En caso de encontrar un mutex con el mismo nombre al introducido, devolver error */
-		if(strcmp(lista_mutex[i].name, mutex_name) == 0){
-			return -1;
-		}
+	char *maximum = getenv(MAX_MUTEX_ENV);
+	unsigned int buckets = 1;
+
+	if(maximum != NULL) num_mutex = atoi(maximum);
+	if(num_mutex < NUM_MUT) num_mutex = NUM_MUT;
+	if(num_mutex > MAX_MUTEX_TOPE) num_mutex = MAX_MUTEX_TOPE;
+
+	while(buckets < 2 * (unsigned int)num_mutex) buckets *= 2;
+	mascara_indice_mutex = buckets - 1;
+
+	lista_mutex = calloc(num_mutex, sizeof(mutex));
+	indice_mutex = malloc(buckets * sizeof(int));
+	if(lista_mutex == NULL || indice_mutex == NULL)
+		panico("no hay memoria para la lista de mutex");
+
+	for(unsigned int i = 0; i < buckets; i++) indice_mutex[i] = -1;
+
+	/* Todas las entradas empiezan libres, en orden */
+	for(int i = num_mutex - 1; i >= 0; i--){
+		lista_mutex[i].next = mutex_libres;
+		mutex_libres = i;
 	}
+	printk("-> MUTEX DEL SISTEMA: %d\n", num_mutex);
+}
 
-	return 1;
+/* Resumen FNV-1a del nombre de un mutex */
+static unsigned int mutex_name_hash(char *mutex_name){
+
+	unsigned int hash = 2166136261U;
+
+	for(; *mutex_name != '\0'; mutex_name++){
+		hash ^= (unsigned char)*mutex_name;
+		hash *= 16777619U;
+	}
+	return hash;
 }
 
 /* Función que busca la posición del mutex en la lista de mutex */
 int mutex_search_name(char *mutex_name){
 
-	for(int i = 0; i < NUM_MUT; i++){
-		if(strcmp(lista_mutex[i].name, mutex_name) == 0){
-			return i;
-		}
+	unsigned long long start = instante_ns();
+	unsigned int hash = mutex_name_hash(mutex_name);
+	int i = indice_mutex[hash & mascara_indice_mutex];
+
+	/* Sólo se comparan los nombres con el mismo resumen */
+	while(i != -1 && (lista_mutex[i].name_hash != hash ||
+		strcmp(lista_mutex[i].name, mutex_name) != 0)){
+		i = lista_mutex[i].next;
 	}
-	return -1;
+
+	busquedas_mutex++;
+	busqueda_mutex_ns += instante_ns() - start;
+	return i;
+}
+
+/* Función que revisa que el nombre introducido al nuevo mutex no se encuentra actualmente en uso */
+int mutex_name_taken(char *mutex_name){
+
+	return (mutex_search_name(mutex_name) != -1) ? -1 : 1;
 }
 
-/* Función que revisa si hay un hueco en la lista de mutex para el nuevo mutex comprobando que
-	el nombre sea igual a NULL */
+/* Función que devuelve un hueco de la lista de mutex para el nuevo mutex, o -1 si no queda ninguno */
 int free_mutex_position(){
 
-	/* Recorrido de la lista de mutex */
-	for(int i = 0; i < NUM_MUT; i++){
-		/* En caso de que el nombre sea igual a vacío significa que
-			la posición en el array está vacía, se devuelve la posición libre */
-		if(strcmp(lista_mutex[i].name, "") == 0){
-			return i;
-		}
-	}
-	return -1;
+	return mutex_libres;
 }
 
-int check_mutex_id(unsigned int mutex_id){
+/* Devuelve el identificador del mutex al que apunta el descriptor del proceso actual, o -1 */
+int check_mutex_id(unsigned int descriptor){
 
-	for(int i = 0; i < NUM_MUT_PROC; i++){
-		if(p_proc_actual->descriptor[i] == mutex_id){
-			return i;
-		}
-	}
-	return -1;
+	int position = buscar_descriptor(p_proc_actual, descriptor, DESC_MUTEX);
+
+	return (position == -1) ? -1 : position + 1;
 }
 
 /* Función que comprueba que el proceso que crea el mutex tenga descriptores libres */
 int process_descriptors(BCPptr process){
 
-	for(int i = 0; i < NUM_MUT_PROC; i++){
-		if(process->descriptor[i] == 0){
-			return i;
-		}
-	}
-	return -1;
+	return reservar_descriptor(process);
 }
 
-/* Genera la estructura del nuevo mutex con los datos introducidos */
-mutex generate_mutex(char *nombre, int tipo){
+/* Genera el nuevo mutex con los datos introducidos en la posición libre
+	indicada, que pasa de la cadena de libres a la de su nombre */
+void generate_mutex(int position, char *nombre, int tipo){
+
+	mutex* generated_mutex = &lista_mutex[position];
+	unsigned int hash = mutex_name_hash(nombre);
+	int *bucket = &indice_mutex[hash & mascara_indice_mutex];
 
-	mutex generated_mutex;
+	mutex_libres = generated_mutex->next;
 
-	strcpy(generated_mutex.name, nombre);
-	generated_mutex.type = tipo;
-	generated_mutex.lock_process = NULL;
-	generated_mutex.lock_amount = 0;
-	generated_mutex.descriptor_amount = 1;
+	strcpy(generated_mutex->name, nombre);
+	generated_mutex->name_hash = hash;
+	generated_mutex->type = tipo;
+	generated_mutex->lock_process = NULL;
+	generated_mutex->lock_amount = 0;
+	generated_mutex->descriptor_amount = 1;
+	generated_mutex->donado = 0;
+	iniciar_lista(&generated_mutex->waiting_process, ENLACE_ESPERA);
 
-	return generated_mutex;
+	generated_mutex->next = *bucket;
+	*bucket = position;
 }
 
 void erase_mutex(unsigned int mutex_id){
 
-	mutex* actual_mutex = &lista_mutex[(mutex_id-1)];
+	int position = mutex_id - 1;
+	mutex* actual_mutex = &lista_mutex[position];
+	int *link = &indice_mutex[actual_mutex->name_hash & mascara_indice_mutex];
+
+	/* Se saca de la cadena de su nombre y pasa a la de libres */
+	while(*link != position) link = &lista_mutex[*link].next;
+	*link = actual_mutex->next;
 
 	strcpy(actual_mutex->name,"");
+	actual_mutex->next = mutex_libres;
+	mutex_libres = position;
+}
+
+/*
+ * Donación de rodaja. El que se bloquea en un mutex cogido presta al dueño
+ * lo que le queda de rodaja. El dueño lo guarda en donacion, aparte de su
+ * propia rodaja, que la política maneja sin verlo; round_robin gasta lo
+ * prestado antes que la rodaja propia y pick_next lo elige antes que a los
+ * de la política mientras le quede. Lo prestado se anota en el mutex y en
+ * el dueño, así que al soltar del todo un mutex se retira la parte no
+ * consumida que no cubran los demás que tenga. El que espera se queda sin
+ * rodaja. Lo consumido se descuenta de lo que prestaron los que esperan,
+ * por orden de llegada, y cada uno recupera lo que le quede al coger el
+ * mutex; el resto de lo prestado por los que siguen en cola pasa al nuevo
+ * dueño.
+ */
+
+/*
+ * En lista_donados solo están los dueños con rodaja prestada que pueden
+ * ejecutar: listos o en ejecución, fuera de la clase de tiempo real y sin
+ * apartar por su grupo. Salen al bloquearse y vuelven al despertar, así
+ * que pick_next solo mira el primero.
+ */
+static int en_donados(BCP *proc){
+	return lista_donados.primero==proc ||
+		anterior_BCP(&lista_donados, proc)!=NULL;
+}
+
+static void donados_poner(BCP *proc){
+	if (proc->donacion>0 && !proc->rt_period &&
+	    (proc->estado==LISTO || proc->estado==EJECUCION) && !en_donados(proc))
+		insertar_ultimo(&lista_donados, proc);
+}
+
+static void donados_quitar(BCP *proc){
+	if (en_donados(proc))
+		eliminar_elem(&lista_donados, proc);
+}
+
+/*
+ * Suma ticks prestados al dueño de un mutex
+ */
+static void sumar_donacion(BCP *dueno, int ticks){
+	if (ticks<=0)
+		return;
+	dueno->donado_total+=ticks;
+	dueno->donacion+=ticks;
+	donados_poner(dueno);
+}
+
+/*
+ * El proceso que va a bloquearse en el mutex presta su rodaja al dueño
+ */
+static void donar_rodaja(BCP *proc, mutex *m){
+	int ticks=proc->robin_seconds;
+
+	if (!donacion_activa || m->lock_process==NULL || ticks<=0)
+		return;
+	printk("-> PROC %d PRESTA %d TICKS A %d\n", proc->id, ticks,
+		m->lock_process->id);
+	proc->rodaja_prestada=ticks;
+	proc->robin_seconds=0;
+	m->donado+=ticks;
+	sumar_donacion(m->lock_process, ticks);
+	donaciones++;
+	ticks_prestados+=ticks;
+}
+
+/*
+ * Consume un TICK de lo prestado al proceso en ejecución. Cuando lo agota
+ * deja de pasar por delante, aunque siga teniendo el mutex.
+ */
+static void consumir_donacion(BCP *dueno){
+	ticks_adelantados++;
+	if (--dueno->donacion==0)
+		donados_quitar(dueno);
+}
+
+/*
+ * El dueño suelta del todo el mutex: lo que le queda prestado no puede
+ * superar lo que le prestan por los mutex que sigue teniendo. El sobrante
+ * es lo que no ha consumido de lo prestado por los que esperan este mutex,
+ * y lo consumido se descuenta de sus préstamos por orden de llegada.
+ */
+static void retirar_donacion(BCP *dueno, mutex *m){
+	int sobrante, consumido, parte;
+	BCP *proc;
+
+	dueno->donado_total-=m->donado;
+	sobrante=dueno->donacion - dueno->donado_total;
+	if (sobrante<0)
+		sobrante=0;
+	dueno->donacion-=sobrante;
+	if (dueno->donacion==0)
+		donados_quitar(dueno);
+
+	consumido=m->donado - sobrante;
+	for (proc=m->waiting_process.primero; proc && consumido>0;
+	     proc=siguiente_BCP(&m->waiting_process, proc)) {
+		parte=(proc->rodaja_prestada < consumido) ? proc->rodaja_prestada : consumido;
+		proc->rodaja_prestada-=parte;
+		consumido-=parte;
+	}
+	m->donado=sobrante;
 }
 
 /* Función que bloquea el mutex */
@@ -543,7 +3540,7 @@ void block_mutex_process(){
 	BCPptr blocked_process = p_proc_actual;
 	blocked_process->estado = BLOQUEADO;
 
-	eliminar_elem(&lista_listos, blocked_process);
+	ready_block(blocked_process);
 	insertar_ultimo(&lista_espera_mutex, blocked_process);
 
 	p_proc_actual = planificador();
@@ -558,10 +3555,8 @@ void unblock_mutex_process(){
 
 	BCPptr unblocked_process = lista_espera_mutex.primero;
 
-	unblocked_process->estado = LISTO;
-
 	eliminar_primero(&lista_espera_mutex);
-	insertar_ultimo(&lista_listos, unblocked_process);
+	ready_wakeup(unblocked_process);
 
 	fijar_nivel_int(interruption_level);
 }
@@ -573,7 +3568,8 @@ void block_locking_process(unsigned int mutex_id){
 	BCPptr locking_process = p_proc_actual;
 	p_proc_actual->estado = BLOQUEADO;
 
-	eliminar_elem(&lista_listos, locking_process);
+	donar_rodaja(locking_process, &lista_mutex[(mutex_id - 1)]);
+	ready_block(locking_process);
 	insertar_ultimo(&lista_mutex[(mutex_id - 1)].waiting_process, locking_process);
 
 	p_proc_actual = planificador();
@@ -586,10 +3582,20 @@ void block_locking_process(unsigned int mutex_id){
 void unblock_locking_process(unsigned int mutex_id){
 	
 	int interruption_level = fijar_nivel_int(NIVEL_3);
-	BCPptr locking_process = lista_mutex[(mutex_id - 1)].waiting_process.primero;
-	eliminar_primero(&lista_mutex[(mutex_id - 1)].waiting_process);
-	insertar_ultimo(&lista_listos, locking_process);
-	lista_mutex[(mutex_id - 1)].lock_process = locking_process;
+	mutex* actual_mutex = &lista_mutex[(mutex_id - 1)];
+	BCPptr locking_process = actual_mutex->waiting_process.primero;
+	eliminar_primero(&actual_mutex->waiting_process);
+
+	/* Recupera lo que prestó y no se ha consumido */
+	actual_mutex->donado -= locking_process->rodaja_prestada;
+	locking_process->robin_seconds += locking_process->rodaja_prestada;
+	ticks_devueltos += locking_process->rodaja_prestada;
+	locking_process->rodaja_prestada = 0;
+	actual_mutex->lock_process = locking_process;
+
+	/* El nuevo dueño hereda lo que le prestan los que siguen esperando */
+	sumar_donacion(locking_process, actual_mutex->donado);
+	ready_wakeup(locking_process);
 
 	fijar_nivel_int(interruption_level);
 }
@@ -600,18 +3606,11 @@ void free_blocked_process(unsigned int mutex_id){
 
 	mutex* actual_mutex = &lista_mutex[(mutex_id - 1)];
 
-	BCPptr waiting_process = actual_mutex->waiting_process.primero;
-	BCPptr next_waiting_process = NULL;
-
-	while(waiting_process != NULL){
-		next_waiting_process = waiting_process->siguiente;
+	BCPptr waiting_process;
 
+	while((waiting_process = actual_mutex->waiting_process.primero) != NULL){
 		eliminar_primero(&actual_mutex->waiting_process);
-		insertar_ultimo(&lista_listos, waiting_process);
-
-		waiting_process->estado = LISTO;
-
-		waiting_process = next_waiting_process;
+		ready_wakeup(waiting_process);
 	}
 
 	fijar_nivel_int(interruption_level);
@@ -634,21 +3633,25 @@ int check_locking_process(unsigned int mutexid, BCPptr process){
 int crear_mutex(char *nombre, int tipo){
 
 	/* Lectura del registro 1 para obtener el nombre */
-	char* mutex_name = (char*)leer_registro(1);
+	char* user_name = (char*)leer_registro(1);
 
 	/* Lectura del registro 2 para obtener el tipo */
 	int mutex_type = (int)leer_registro(2);
 
+	char mutex_name[MAX_NOM_MUT];
+	int position;
+
 	/* Se guarda el nivel de interrupción */
 	int interruption_level = fijar_nivel_int(NIVEL_1);
 
 	/* Comprobación del tamaño del nombre introducido */
-	if(strlen(mutex_name) > (MAX_NOM_MUT - 1)){
+	if(strlen(user_name) > (MAX_NOM_MUT - 1)){
 		/* En caso de que el nombre introducido sea mayor que el tamaño
 			del nombre del mutex, este se acorta. */
 		printk("Nombre introducido mayor de los permitido, el nombre se acortará.\n");
-		mutex_name[MAX_NOM_MUT] = '\0';
 	}
+	strncpy(mutex_name, user_name, MAX_NOM_MUT - 1);
+	mutex_name[MAX_NOM_MUT - 1] = '\0';
 
 	if(process_descriptors(p_proc_actual) == -1){
 		printk("El proceso que va a crear el mutex no tiene descriptores libres\n");
@@ -656,30 +3659,29 @@ int crear_mutex(char *nombre, int tipo){
 		return -1;
 	}
 
-	if(mutex_name_taken(mutex_name) == -1){
-		printk("Ya existe un mutex con el mismo nombre.\n");
-		fijar_nivel_int(interruption_level);
-		return -2;
-	}
+	/* Mientras está bloqueado otro proceso puede crear el mismo nombre */
+	while(1){
+		if(mutex_name_taken(mutex_name) == -1){
+			printk("Ya existe un mutex con el mismo nombre.\n");
+			fijar_nivel_int(interruption_level);
+			return -2;
+		}
+
+		if((position = free_mutex_position()) != -1) break;
 
-	if(free_mutex_position() == -1){
 		printk("No hay hueco en la lista de mutex, bloqueando proceso hasta que quede hueco libre.\n");
 		block_mutex_process();
-		fijar_nivel_int(interruption_level);
 	}
 
-	/* Se genera un mutex con el nombre y el tipo introducidos */
-	mutex generated_mutex = generate_mutex(mutex_name, mutex_type);
-
-	/* Se añade el mutex generado a la primera posición libre de la lista de mutex */
-	lista_mutex[free_mutex_position()] = generated_mutex;
+	/* Se genera un mutex con el nombre y el tipo introducidos en la posición libre */
+	generate_mutex(position, mutex_name, mutex_type);
 
 	/* Se añade el descriptor del mutex creado al proceso que lo ha creado */
-	p_proc_actual->descriptor[process_descriptors(p_proc_actual)] = (free_mutex_position() + 1);
+	int desc = abrir_descriptor(p_proc_actual, DESC_MUTEX, position);
 
 	fijar_nivel_int(interruption_level);
 	printk("Mutex %s creado con éxito.\n",mutex_name);
-	return 0;
+	return desc;
 }
 
 /*
@@ -690,27 +3692,34 @@ int abrir_mutex(char *nombre){
 
 	printk("Comenzando a abrir el mutex.\n");
 
-	char* mutex_name = (char*)leer_registro(1);
+	char* user_name = (char*)leer_registro(1);
+	char mutex_name[MAX_NOM_MUT];
 	int interruption_level = fijar_nivel_int(NIVEL_1);
 
+	/* Se acorta igual que al crearlo para que el nombre largo lo encuentre */
+	strncpy(mutex_name, user_name, MAX_NOM_MUT - 1);
+	mutex_name[MAX_NOM_MUT - 1] = '\0';
+
 	if(process_descriptors(p_proc_actual) == -1){
 		printk("El proceso que intenta abrir el mutex no tiene descriptores libres.\n");
 		fijar_nivel_int(interruption_level);
 		return -1;
 	}
 
-	if(mutex_search_name(mutex_name) == -1){
+	int position = mutex_search_name(mutex_name);
+
+	if(position == -1){
 		printk("No existe un mutex con el nombre introducido.\n");
 		fijar_nivel_int(interruption_level);
 		return -2;
 	}
 
-	p_proc_actual->descriptor[process_descriptors(p_proc_actual)] = (mutex_search_name(mutex_name) + 1);
-	lista_mutex[mutex_search_name(mutex_name)].descriptor_amount++;
+	int desc = abrir_descriptor(p_proc_actual, DESC_MUTEX, position);
+	lista_mutex[position].descriptor_amount++;
 	
 	fijar_nivel_int(interruption_level);
 	printk("Mutex abierto correctamente.\n");
-	return (mutex_search_name(mutex_name) + 1);
+	return desc;
 }
 
 /*
@@ -721,11 +3730,13 @@ int lock(unsigned int mutexid){
 
 	printk("Comenzando a realizar el lock.\n");
 
-	unsigned int mutex_id = (unsigned int)leer_registro(1);
+	unsigned int descriptor = (unsigned int)leer_registro(1);
 
 	int interruption_level = fijar_nivel_int(NIVEL_1);
 
-	if(check_mutex_id(mutex_id) == -1){
+	int mutex_id = check_mutex_id(descriptor);
+
+	if(mutex_id == -1){
 		printk("El proceso no cuenta con el mutex indicado entre sus descriptores.\n");
 		fijar_nivel_int(interruption_level);
 		return -1;
@@ -759,10 +3770,12 @@ int lock(unsigned int mutexid){
 int unlock(unsigned int mutexid){
 
 	printk("Comenzando a realizar el unlock.\n");
-	unsigned int mutex_id = (unsigned int)leer_registro(1);
+	unsigned int descriptor = (unsigned int)leer_registro(1);
 	int interruption_level = fijar_nivel_int(NIVEL_1);
 
-	if(check_mutex_id(mutex_id) == -1){
+	int mutex_id = check_mutex_id(descriptor);
+
+	if(mutex_id == -1){
 		printk("El proceso no cuenta con el descriptor suministrado.\n");
 		fijar_nivel_int(interruption_level);
 		return -1;
@@ -783,6 +3796,7 @@ int unlock(unsigned int mutexid){
 	}
 
 	lista_mutex[(mutex_id - 1)].lock_process = NULL;
+	retirar_donacion(p_proc_actual, &lista_mutex[(mutex_id - 1)]);
 
 	if(lista_mutex[(mutex_id-1)].waiting_process.primero == NULL){
 		printk("No quedan procesos esperando al mutex. Unlock realizado con éxito.\n");
@@ -797,32 +3811,25 @@ int unlock(unsigned int mutexid){
 }
 
 /*
- *	Cerrar mutex
+ *	Cierra el descriptor pos del proceso, desbloqueando el mutex si lo
+ *	tenía y borrándolo si era el último en usarlo
  */
+static void cerrar_descriptor(BCP *proc, int pos){
 
-int cerrar_mutex(unsigned int mutexid){
-
-	unsigned int mutex_id = (unsigned int)leer_registro(1);
-	if(mutex_id < 16) mutexid = mutex_id;
-	int interruption_level = fijar_nivel_int(NIVEL_1);
-
-	
-
-	if(check_mutex_id(mutexid) == -1){
-		printk("El proceso no cuenta con el descriptor suministrado.\n");
-		fijar_nivel_int(interruption_level);
-		return -1;
-	}
-
+	unsigned int mutexid = proc->descriptores[pos].objeto + 1;
 	mutex* actual_mutex = &lista_mutex[(mutexid-1)];
 
-	if(actual_mutex->lock_process == p_proc_actual){
+	int liberado = 0;
+
+	if(actual_mutex->lock_process == proc){
 		printk("El proceso está bloqueando el proceso, desbloqueando.\n");
 		actual_mutex->lock_process = NULL;
 		actual_mutex->lock_amount = 0;
+		retirar_donacion(proc, actual_mutex);
+		liberado = 1;
 	}
 
-	p_proc_actual->descriptor[check_mutex_id(mutexid)] = 0;
+	liberar_descriptor(proc, pos);
 	actual_mutex->descriptor_amount--;
 
 	if(actual_mutex->descriptor_amount == 0){
@@ -830,13 +3837,31 @@ int cerrar_mutex(unsigned int mutexid){
 		erase_mutex(mutexid);
 		printk("Mutex borrado correctamente.\n");
 		if(lista_espera_mutex.primero != NULL) unblock_mutex_process();
+		return;
+	}
+
+	/* Solo se pasa el mutex al siguiente si este proceso lo tenía */
+	if(liberado && actual_mutex->waiting_process.primero != NULL) unblock_locking_process(mutexid);
+	printk("Mutex cerrado correctamente.\n");
+}
+
+/*
+ *	Cerrar mutex
+ */
+
+int cerrar_mutex(unsigned int mutexid){
+
+	unsigned int descriptor = (unsigned int)leer_registro(1);
+	int interruption_level = fijar_nivel_int(NIVEL_1);
+
+	if(check_mutex_id(descriptor) == -1){
+		printk("El proceso no cuenta con el descriptor suministrado.\n");
 		fijar_nivel_int(interruption_level);
-		return 0;
+		return -1;
 	}
 
-	if(actual_mutex->waiting_process.primero != NULL) unblock_locking_process(mutexid);
+	cerrar_descriptor(p_proc_actual, descriptor);
 	fijar_nivel_int(interruption_level);
-	printk("Mutex cerrado correctamente.\n");
 	return 0;
 }
 
@@ -854,12 +3879,21 @@ void robin_process_change(){
 	BCPptr actual_process = p_proc_actual;
 	int interruption_level = fijar_nivel_int(NIVEL_3);
 
-	eliminar_primero(&lista_listos);
-	insertar_ultimo(&lista_listos, actual_process);
+	/* Proceso despertado que, según la regla de expulsión, debe ejecutarse */
+	BCPptr preferred_process = proc_preferido;
+	proc_preferido = NULL;
+
+	/* La interrupción SW puede tratarse cuando el proceso ya ha dejado la UCP */
+	if(actual_process->estado != EJECUCION){
+		fijar_nivel_int(interruption_level);
+		return;
+	}
+
+	/* Vuelve a listos según la política de planificación */
+	ready_expire(actual_process);
+
+	p_proc_actual = planificar_hacia(preferred_process);
 
-	p_proc_actual = planificador();
-	if(p_proc_actual->robin_seconds < TICKS_POR_RODAJA) p_proc_actual->robin_seconds = TICKS_POR_RODAJA;
-	
 	fijar_nivel_int(interruption_level);
 	cambio_contexto(&(actual_process->contexto_regs), &(p_proc_actual->contexto_regs));
 }
@@ -884,6 +3918,15 @@ int main(){
 	iniciar_cont_teclado();		/* inici cont. teclado */
 
 	iniciar_tabla_proc();		/* inicia BCPs de tabla de procesos */
+	iniciar_rueda();		/* inicia las ranuras de la rueda */
+
+	elegir_planificador();		/* fija la política de planificación */
+	elegir_expulsion();		/* fija la regla de expulsión al despertar */
+	elegir_reloj();			/* fija el modo de la frecuencia de reloj */
+	elegir_reserva_pilas();		/* fija el máximo de la reserva de pilas */
+	elegir_cache_imagenes();	/* fija el máximo de la caché de imágenes */
+	elegir_carga_diferida();	/* fija si los programas se cargan al ejecutar */
+	iniciar_mutex();		/* reserva la lista de mutex y su índice */
 
 	/* crea proceso inicial */
 	if (crear_tarea((void *)"init")<0)
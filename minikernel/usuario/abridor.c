@@ -35,9 +35,9 @@ int main(){
 	if (abrir_mutex("m4")<0)
 		printf("error abriendo m4. NO DEBE SALIR\n");
 
-	/* Error: ha agotado los descriptores */
+	/* La tabla de descriptores crece: ya no se agotan con cuatro */
 	if (abrir_mutex("m5")<0)
-		printf("error abriendo m5. DEBE SALIR\n");
+		printf("error abriendo m5. NO DEBE SALIR\n");
 
 	/* libera un descriptor de mutex (m1) */
 	cerrar_mutex(desc);
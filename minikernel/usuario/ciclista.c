@@ -0,0 +1,26 @@
+/*
+ * usuario/ciclista.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que se bloquea y despierta CICLOS veces, una por
+ * TICK, sin escribir nada. Lo usa prueba_colas.
+ */
+
+#include "servicios.h"
+
+#define CICLOS 20
+
+int main(){
+	int i;
+
+	dormir_ticks(1);	/* se sincroniza con los demás */
+	for (i=0; i<CICLOS; i++)
+		dormir_ticks(1);
+	return 0;
+}
@@ -0,0 +1,35 @@
+/*
+ * usuario/consumidor.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que "gasta CPU" durante bastante tiempo y muestra
+ * la fracción de UCP que ha recibido frente a la que le corresponde.
+ */
+
+#include "servicios.h"
+
+#define TOT_ITER 20	/* ponga las que considere oportuno */
+#define ITER_VUELTA 20000000
+
+int main(){
+	int i, j, tot, id;
+	unsigned int real, objetivo;
+
+	id=obtener_id_pr();
+	for (i=0; i<TOT_ITER; i++) {
+		for (j=0; j<ITER_VUELTA; j++)
+			tot=j*i;
+		obtener_reparto(&real, &objetivo);
+		printf("consumidor (%d): vuelta %d reparto real %d/1000 objetivo %d/1000\n",
+			id, i, real, objetivo);
+	}
+	printf("consumidor (%d): termina\n", id);
+	tot--;
+	return 0;
+}
@@ -13,6 +13,8 @@
 
 #include "servicios.h"
 
+#define MAX_SEGS 8
+
 int main(){
 	int segs, id;
 
@@ -23,8 +25,9 @@ int main(){
 	printf("dormilon (%d) duerme 1 segundo\n", id);
 	dormir(1);
 
-	/* despues duerme numero de segundos dependiendo de su pid */
-	segs=id+1;
+	/* despues duerme numero de segundos dependiendo de su pid, acotado
+		porque una entrada reutilizada da un pid muy alto */
+	segs=id%MAX_SEGS+1;
 	printf("dormilon (%d) duerme %d segundos\n", id, segs);
 	dormir(segs);
 
@@ -0,0 +1,28 @@
+/*
+ * usuario/durmiente.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que duerme varias veces, cada una un número de
+ * segundos que depende de su pid, e indica cada vez que despierta
+ */
+
+#include "servicios.h"
+
+#define VECES 3
+
+int main(){
+	int i, id;
+
+	id=obtener_id_pr();
+	for (i=0; i<VECES; i++) {
+		dormir(1 + (id+i)%3);
+		printf("durmiente (%d): despierta (%d)\n", id, i);
+	}
+	return 0;
+}
@@ -0,0 +1,36 @@
+/*
+ * usuario/esperador.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que espera a coger un mutex que tiene prueba_donacion
+ * y lo suelta. Los de identificador par usan "convoy" y los impares
+ * "interno". Termina con estado 1 si al coger el mutex hereda lo que le
+ * prestan los que siguen esperando y con 0 si no.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int desc, rodaja, pendiente;
+	unsigned int prestados, adelantados, devueltos;
+
+	desc=abrir_mutex((obtener_id_pr()%2) ? "interno" : "convoy");
+	if (desc<0) {
+		printf("esperador: error abriendo el mutex. NO DEBE SALIR\n");
+		return -1;
+	}
+	lock(desc);
+	obtener_donacion(&prestados, &adelantados, &devueltos, &rodaja, &pendiente);
+	if (pendiente>0)
+		printf("esperador (%d): hereda %d TICKs prestados, rodaja propia %d\n",
+			obtener_id_pr(), pendiente, rodaja);
+	unlock(desc);
+	salir(pendiente>0);	/* cierre implícito del mutex */
+	return 0;
+}
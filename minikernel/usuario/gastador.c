@@ -0,0 +1,25 @@
+/*
+ * usuario/gastador.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que gasta UCP durante DURACION TICKs, consultando el
+ * TICK actual sin bloquearse. Lo usa prueba_donacion.
+ */
+
+#include "servicios.h"
+
+#define DURACION 300
+
+int main(){
+	int fin=dormir_hasta(0)+DURACION;
+
+	while (dormir_hasta(0)<fin)
+		;
+	return 0;
+}
@@ -0,0 +1,32 @@
+/*
+ * usuario/holgazan.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que duerme varias veces un número de TICKs que
+ * depende de su pid, con la holgura que haya heredado, e indica en qué
+ * TICK despierta cada vez
+ */
+
+#include "servicios.h"
+
+#define VECES 5
+#define MAX_ESPERAS 8
+
+int main(){
+	int i, id, tick;
+
+	/* Con entradas reutilizadas el pid lleva la generación en los bits
+		altos; se acota para no dormir miles de TICKs */
+	id=obtener_id_pr();
+	for (i=0; i<VECES; i++) {
+		tick=dormir_ticks(7 + 3*(id%MAX_ESPERAS));
+		printf("holgazan (%d): despierta en %d\n", id, tick);
+	}
+	return 0;
+}
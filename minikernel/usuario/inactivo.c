@@ -0,0 +1,22 @@
+/*
+ * usuario/inactivo.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que se limita a dormir un rato y terminar sin
+ * escribir nada. Sirve para tener muchos procesos vivos a la vez.
+ */
+
+#include "servicios.h"
+
+#define SEGUNDOS 10
+
+int main(){
+	dormir(SEGUNDOS);
+	return 0;
+}
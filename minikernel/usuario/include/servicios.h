@@ -30,8 +30,9 @@
 int escribirf(const char *formato, ...);
 
 /* Llamadas al sistema proporcionadas */
-int crear_proceso(char *prog);
-int terminar_proceso();
+int crear_proceso(char *prog);	/* devuelve el id del nuevo proceso */
+int terminar_proceso();		/* termina con estado 0 */
+int salir(int estado);		/* termina con el estado indicado */
 int escribir(char *texto, unsigned int longi);
 int obtener_id_pr();
 
@@ -39,11 +40,91 @@ int obtener_id_pr();
 int dormir(unsigned int seconds);
 
 /* Llamadas al sistema de tratamiento de mutex */
-int crear_mutex(char *nombre, int tipo);
+int crear_mutex(char *nombre, int tipo);	/* devuelve el descriptor */
 int abrir_mutex(char *nombre);
 int lock(unsigned int mutexid);
 int unlock(unsigned int mutexid);
 int cerrar_mutex(unsigned int mutexid);
 
+/* Llamadas al sistema de tratamiento de prioridades */
+int fijar_prioridad(unsigned int prioridad);
+int obtener_prioridad();
+
+/* Llamadas al sistema de reparto proporcional de UCP */
+int fijar_tickets(unsigned int tickets);
+int obtener_reparto(unsigned int *real, unsigned int *objetivo);
+
+/* Llamadas al sistema de la clase de tiempo real */
+int fijar_tiempo_real(unsigned int periodo, unsigned int presupuesto, unsigned int plazo);
+int esperar_periodo();
+
+/* Llamada al sistema de consulta de la rodaja adaptativa */
+#define QUANTUM_HIST 8 /* rodajas que devuelve obtener_rodaja */
+int obtener_rodaja(unsigned int *historia);
+
+/* Llamadas al sistema de cesión voluntaria de la UCP */
+int ceder_procesador();
+int ceder_a(int pid);
+
+/* Llamadas al sistema de los grupos con cuota de UCP */
+int crear_grupo(unsigned int cuota, unsigned int periodo);
+int obtener_uso_grupo(unsigned int grupo, unsigned int *consumo, unsigned int *estrangulamientos);
+
+/* Llamada al sistema de consulta del coste del tratamiento de los dormidos */
+int obtener_coste_dormir(unsigned int *ticks, unsigned int *visitas, unsigned int *lineal);
+
+/* Llamadas al sistema de espera con resolución de TICK y temporizadores */
+int dormir_ticks(unsigned int ticks);
+int dormir_hasta(unsigned int tick);
+int crear_temporizador(unsigned int periodo);
+int esperar_temporizador(int temporizador);
+
+/* Llamadas al sistema de la holgura de los temporizadores */
+int fijar_holgura(unsigned int holgura);
+int obtener_agrupamiento(unsigned int *agrupados, unsigned int *ahorradas);
+
+/* Llamada al sistema de consulta del ahorro de la frecuencia de reloj dinámica */
+int obtener_ahorro_reloj(unsigned int *evitadas, unsigned int *tranquilos);
+
+/* Llamadas al sistema de la reserva de pilas */
+int fijar_reserva_pilas(unsigned int maximo);
+int obtener_reserva_pilas(unsigned int *aciertos, unsigned int *fallos, unsigned int *arranque_ns);
+
+/* Llamadas al sistema de la caché de imágenes. Está desactivada por
+	defecto: con ella, cada ejecución de un programa reutiliza los datos
+	globales de la anterior en vez de empezar con los iniciales */
+int fijar_cache_imagenes(unsigned int maximo);
+int obtener_cache_imagenes(unsigned int *aciertos, unsigned int *fallos, unsigned int *carga_ns);
+
+/* Llamada al sistema de creación de procesos por lotes. Los procesos de
+	un lote comparten la imagen, y sus datos globales, aunque la caché de
+	imágenes esté desactivada */
+int crear_procesos(char *prog, int n, int *pids);	/* devuelve los creados */
+
+/* Llamada al sistema de consulta de la liberación diferida de procesos */
+int obtener_recogida(unsigned int *fin_ns, unsigned int *recogida_ns);
+
+/* Llamada al sistema de espera a un hijo. Deja en estado el que pasó a
+	salir, 0 si volvió de main o -1 si terminó por una excepción */
+int esperar_proceso(int pid, int *estado);
+
+/* Llamadas al sistema de la carga diferida de los programas. Con ella
+	activa, crear_proceso no comprueba el programa: si no se puede cargar,
+	esperar_proceso deja en estado -2 */
+int fijar_carga_diferida(unsigned int activa);	/* devuelve el modo anterior */
+int obtener_carga_diferida(unsigned int *creacion_ns, unsigned int *carga_ns);
+
+/* Llamada al sistema de consulta del índice de nombres de mutex. Devuelve
+	el número de mutex del sistema */
+int obtener_nombres_mutex(unsigned int *busquedas, unsigned int *busqueda_ns);
+
+/* Llamadas al sistema de la donación de rodaja a los dueños de mutex.
+	obtener_donacion devuelve los préstamos desde fijar_donacion, con los
+	TICKs prestados, los consumidos y los devueltos a quien los prestó, y
+	deja en rodaja la propia que le queda al proceso y en pendiente, aparte,
+	lo que le han prestado y aún no ha consumido */
+int fijar_donacion(unsigned int activa);	/* devuelve el modo anterior */
+int obtener_donacion(unsigned int *prestados, unsigned int *adelantados, unsigned int *devueltos, int *rodaja, int *pendiente);
+
 #endif /* SERVICIOS_H */
 
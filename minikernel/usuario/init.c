@@ -91,6 +91,102 @@ ALGO COMENTE ESTA PARTE Y DESCOMENTE LA PRUEBA CORRESPONDIENTE */
 		printf("Error creando prueba_term\n");
 */
 
+/* PRUEBA DE PRIORIDADES ESTÁTICAS
+	if (crear_proceso("prueba_prioridad")<0)
+		printf("Error creando prueba_prioridad\n");
+*/
+
+/* PRUEBA DEL REPARTO PROPORCIONAL (arrancar con MINIKERNEL_PLANIF=stride o lottery)
+	if (crear_proceso("prueba_tickets")<0)
+		printf("Error creando prueba_tickets\n");
+*/
+
+/* PRUEBA DE LA CLASE DE TIEMPO REAL
+	if (crear_proceso("prueba_tiempo_real")<0)
+		printf("Error creando prueba_tiempo_real\n");
+*/
+
+/* PRUEBA DE LA RODAJA ADAPTATIVA (arrancar con MINIKERNEL_PLANIF=adaptive)
+	if (crear_proceso("prueba_rodaja")<0)
+		printf("Error creando prueba_rodaja\n");
+*/
+
+/* PRUEBA DE LA CESIÓN VOLUNTARIA DE LA UCP
+	if (crear_proceso("prueba_ceder")<0)
+		printf("Error creando prueba_ceder\n");
+*/
+
+/* PRUEBA DE LA EXPULSIÓN AL DESPERTAR (comparar con MINIKERNEL_EXPULSION=nunca)
+	if (crear_proceso("prueba_expulsion")<0)
+		printf("Error creando prueba_expulsion\n");
+*/
+
+/* PRUEBA DE LA CUOTA DE UCP POR GRUPOS
+	if (crear_proceso("prueba_grupos")<0)
+		printf("Error creando prueba_grupos\n");
+*/
+
+/* PRUEBA DE LA RUEDA DE TEMPORIZACIÓN DE LOS PROCESOS DORMIDOS
+	if (crear_proceso("prueba_rueda")<0)
+		printf("Error creando prueba_rueda\n");
+*/
+
+/* PRUEBA DE LAS ESPERAS POR TICKS Y LOS TEMPORIZADORES PERIÓDICOS
+	if (crear_proceso("prueba_temporizador")<0)
+		printf("Error creando prueba_temporizador\n");
+*/
+
+/* PRUEBA DE LA HOLGURA DE LOS TEMPORIZADORES
+	if (crear_proceso("prueba_holgura")<0)
+		printf("Error creando prueba_holgura\n");
+*/
+
+/* PRUEBA DE LA FRECUENCIA DE RELOJ DINÁMICA (arrancar con MINIKERNEL_RELOJ=dinamico)
+	if (crear_proceso("prueba_reloj")<0)
+		printf("Error creando prueba_reloj\n");
+*/
+
+/* PRUEBA DEL RITMO DE CREACIÓN DE PROCESOS CON LA TABLA AMPLIABLE
+	if (crear_proceso("prueba_creacion")<0)
+		printf("Error creando prueba_creacion\n");
+*/
+
+/* PRUEBA DE LOS CICLOS DE BLOQUEO CON COLAS DE LISTOS LARGAS
+	if (crear_proceso("prueba_colas")<0)
+		printf("Error creando prueba_colas\n");
+*/
+
+/* PRUEBA DE LA RESERVA DE PILAS, LA CACHÉ DE IMÁGENES Y LA LIBERACIÓN Y
+	CARGA DIFERIDAS
+	if (crear_proceso("prueba_arranque")<0)
+		printf("Error creando prueba_arranque\n");
+*/
+
+/* PRUEBA DE LA CREACIÓN DE PROCESOS POR LOTES
+	if (crear_proceso("prueba_lotes")<0)
+		printf("Error creando prueba_lotes\n");
+*/
+
+/* PRUEBA DE LA ESPERA A LOS HIJOS
+	if (crear_proceso("prueba_espera")<0)
+		printf("Error creando prueba_espera\n");
+*/
+
+/* PRUEBA DEL ÍNDICE DE NOMBRES DE MUTEX (con MINIKERNEL_MAX_MUTEX=4096)
+	if (crear_proceso("prueba_nombres")<0)
+		printf("Error creando prueba_nombres\n");
+*/
+
+/* PRUEBA DE LA TABLA DE DESCRIPTORES DE LOS PROCESOS
+	if (crear_proceso("prueba_descriptores")<0)
+		printf("Error creando prueba_descriptores\n");
+*/
+
+/* PRUEBA DE LA DONACIÓN DE RODAJA A LOS DUEÑOS DE MUTEX
+	if (crear_proceso("prueba_donacion")<0)
+		printf("Error creando prueba_donacion\n");
+*/
+
 	printf("init: termina\n");
 	return 0; 
 }
@@ -38,7 +38,10 @@ int crear_proceso(char *prog){
 	return llamsis(CREAR_PROCESO, 1, (long)prog);
 }
 int terminar_proceso(){
-	return llamsis(TERMINAR_PROCESO, 0);
+	return llamsis(TERMINAR_PROCESO, 1, (long)0);
+}
+int salir(int estado){
+	return llamsis(TERMINAR_PROCESO, 1, (long)estado);
 }
 int escribir(char *texto, unsigned int longi){
 	return llamsis(ESCRIBIR, 2, (long)texto, (long)longi);
@@ -63,4 +66,97 @@ int unlock(unsigned int mutexid){
 }
 int cerrar_mutex(unsigned int mutexid){
 	return llamsis(CERRAR_MUTEX, 1, (long)mutexid);
+}
+int fijar_prioridad(unsigned int prioridad){
+	return llamsis(FIJAR_PRIORIDAD, 1, (long)prioridad);
+}
+int obtener_prioridad(){
+	return llamsis(OBTENER_PRIORIDAD, 0);
+}
+int fijar_tickets(unsigned int tickets){
+	return llamsis(FIJAR_TICKETS, 1, (long)tickets);
+}
+int obtener_reparto(unsigned int *real, unsigned int *objetivo){
+	return llamsis(OBTENER_REPARTO, 2, (long)real, (long)objetivo);
+}
+int fijar_tiempo_real(unsigned int periodo, unsigned int presupuesto, unsigned int plazo){
+	return llamsis(FIJAR_TIEMPO_REAL, 3, (long)periodo, (long)presupuesto, (long)plazo);
+}
+int esperar_periodo(){
+	return llamsis(ESPERAR_PERIODO, 0);
+}
+int obtener_rodaja(unsigned int *historia){
+	return llamsis(OBTENER_RODAJA, 1, (long)historia);
+}
+int ceder_procesador(){
+	return llamsis(CEDER_PROCESADOR, 0);
+}
+int ceder_a(int pid){
+	return llamsis(CEDER_A, 1, (long)pid);
+}
+int crear_grupo(unsigned int cuota, unsigned int periodo){
+	return llamsis(CREAR_GRUPO, 2, (long)cuota, (long)periodo);
+}
+int obtener_uso_grupo(unsigned int grupo, unsigned int *consumo, unsigned int *estrangulamientos){
+	return llamsis(OBTENER_USO_GRUPO, 3, (long)grupo, (long)consumo, (long)estrangulamientos);
+}
+int obtener_coste_dormir(unsigned int *ticks, unsigned int *visitas, unsigned int *lineal){
+	return llamsis(OBTENER_COSTE_DORMIR, 3, (long)ticks, (long)visitas, (long)lineal);
+}
+int dormir_ticks(unsigned int ticks){
+	return llamsis(DORMIR_TICKS, 1, (long)ticks);
+}
+int dormir_hasta(unsigned int tick){
+	return llamsis(DORMIR_HASTA, 1, (long)tick);
+}
+int crear_temporizador(unsigned int periodo){
+	return llamsis(CREAR_TEMPORIZADOR, 1, (long)periodo);
+}
+int esperar_temporizador(int temporizador){
+	return llamsis(ESPERAR_TEMPORIZADOR, 1, (long)temporizador);
+}
+int fijar_holgura(unsigned int holgura){
+	return llamsis(FIJAR_HOLGURA, 1, (long)holgura);
+}
+int obtener_agrupamiento(unsigned int *agrupados, unsigned int *ahorradas){
+	return llamsis(OBTENER_AGRUPAMIENTO, 2, (long)agrupados, (long)ahorradas);
+}
+int obtener_ahorro_reloj(unsigned int *evitadas, unsigned int *tranquilos){
+	return llamsis(OBTENER_AHORRO_RELOJ, 2, (long)evitadas, (long)tranquilos);
+}
+int fijar_reserva_pilas(unsigned int maximo){
+	return llamsis(FIJAR_RESERVA_PILAS, 1, (long)maximo);
+}
+int obtener_reserva_pilas(unsigned int *aciertos, unsigned int *fallos, unsigned int *arranque_ns){
+	return llamsis(OBTENER_RESERVA_PILAS, 3, (long)aciertos, (long)fallos, (long)arranque_ns);
+}
+int fijar_cache_imagenes(unsigned int maximo){
+	return llamsis(FIJAR_CACHE_IMAGENES, 1, (long)maximo);
+}
+int obtener_cache_imagenes(unsigned int *aciertos, unsigned int *fallos, unsigned int *carga_ns){
+	return llamsis(OBTENER_CACHE_IMAGENES, 3, (long)aciertos, (long)fallos, (long)carga_ns);
+}
+int crear_procesos(char *prog, int n, int *pids){
+	return llamsis(CREAR_PROCESOS, 3, (long)prog, (long)n, (long)pids);
+}
+int obtener_recogida(unsigned int *fin_ns, unsigned int *recogida_ns){
+	return llamsis(OBTENER_RECOGIDA, 2, (long)fin_ns, (long)recogida_ns);
+}
+int esperar_proceso(int pid, int *estado){
+	return llamsis(ESPERAR_PROCESO, 2, (long)pid, (long)estado);
+}
+int fijar_carga_diferida(unsigned int activa){
+	return llamsis(FIJAR_CARGA_DIFERIDA, 1, (long)activa);
+}
+int obtener_carga_diferida(unsigned int *creacion_ns, unsigned int *carga_ns){
+	return llamsis(OBTENER_CARGA_DIFERIDA, 2, (long)creacion_ns, (long)carga_ns);
+}
+int obtener_nombres_mutex(unsigned int *busquedas, unsigned int *busqueda_ns){
+	return llamsis(OBTENER_NOMBRES_MUTEX, 2, (long)busquedas, (long)busqueda_ns);
+}
+int fijar_donacion(unsigned int activa){
+	return llamsis(FIJAR_DONACION, 1, (long)activa);
+}
+int obtener_donacion(unsigned int *prestados, unsigned int *adelantados, unsigned int *devueltos, int *rodaja, int *pendiente){
+	return llamsis(OBTENER_DONACION, 5, (long)prestados, (long)adelantados, (long)devueltos, (long)rodaja, (long)pendiente);
 }
\ No newline at end of file
@@ -0,0 +1,46 @@
+/*
+ * usuario/periodico.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que simula un bucle de control periódico de tiempo
+ * real: cada 20 TICKs realiza un trabajo corto con un presupuesto de 4
+ * TICKs. En una de las vueltas se excede a propósito del presupuesto,
+ * * lo que debe estrangularlo y contar algún fallo de plazo.
+ */
+
+#include "servicios.h"
+
+#define PERIODO 20	/* TICKs */
+#define PRESUPUESTO 4	/* TICKs */
+#define VUELTAS 10
+#define VUELTA_EXCESO 5	/* vuelta en la que se excede del presupuesto */
+#define ITER_TRABAJO 100000
+#define ITER_EXCESO 40000000
+
+int main(){
+	int i, j, tot, id, fallos=0;
+
+	id=obtener_id_pr();
+	printf("periodico (%d): comienza\n", id);
+
+	if (fijar_tiempo_real(PERIODO, PRESUPUESTO, 0)<0) {
+		printf("periodico (%d): rechazado por la prueba de admision\n", id);
+		return 0;
+	}
+
+	for (i=0; i<VUELTAS; i++) {
+		for (j=0; j<(i==VUELTA_EXCESO ? ITER_EXCESO : ITER_TRABAJO); j++)
+			tot=j*i;
+		fallos=esperar_periodo();
+	}
+
+	printf("periodico (%d): termina con %d plazos incumplidos\n", id, fallos);
+	tot--;
+	return 0;
+}
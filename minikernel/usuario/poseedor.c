@@ -0,0 +1,52 @@
+/*
+ * usuario/poseedor.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que crea POR_POSEEDOR mutex con nombres derivados de
+ * su identificador y los mantiene hasta que puede pasar por el mutex
+ * "barrera", que prueba_nombres tiene cogido mientras mide.
+ */
+
+#include "servicios.h"
+
+#define POR_POSEEDOR 3
+
+/* Nombre del mutex k del poseedor pid: "p", el pid en base 36 y una letra */
+static void nombre_mutex(char *nombre, int pid, int k){
+	char cifras[8];
+	int n=0;
+
+	do {
+		cifras[n++]="0123456789abcdefghijklmnopqrstuvwxyz"[pid%36];
+		pid/=36;
+	} while (pid>0);
+	*nombre++='p';
+	while (n>0)
+		*nombre++=cifras[--n];
+	*nombre++='a'+k;
+	*nombre='\0';
+}
+
+int main(){
+	char nombre[8];
+	int k, pid, barrera;
+
+	pid=obtener_id_pr();
+	for (k=0; k<POR_POSEEDOR; k++) {
+		nombre_mutex(nombre, pid, k);
+		if (crear_mutex(nombre, NO_RECURSIVO)<0)
+			printf("poseedor: error creando %s\n", nombre);
+	}
+
+	if ((barrera=abrir_mutex("barrera"))>=0) {
+		lock(barrera);
+		unlock(barrera);
+	}
+	return 0;	/* cierre implícito de mutex */
+}
@@ -0,0 +1,162 @@
+/*
+ * usuario/prueba_arranque.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba lo que abarata el arranque y el fin de
+ * los procesos: la reserva de pilas, la caché de imágenes, la liberación
+ * diferida y la carga diferida. Cada parte lanza procesos "vacio" con su
+ * mecanismo desactivado y activado, muestra las medidas y comprueba su
+ * efecto. Antes hace una vuelta sin medir para que ninguna parte pague el
+ * calentamiento.
+ */
+
+#include "servicios.h"
+
+#define NUM_ARRANQUES 200
+#define NUM_HIJOS 100
+#define MAX_RESERVA 16
+#define MAX_CACHE 8
+
+/*
+ * Crea n procesos "vacio" uno tras otro, cediéndoles la UCP para que
+ * terminen antes de crear el siguiente
+ */
+static void lanzar_seguidos(int n){
+	int i, pid;
+
+	for (i=0; i<n; i++) {
+		pid=crear_proceso("vacio");
+		if (pid<0)
+			printf("Error creando vacio\n");
+		else
+			ceder_a(pid);
+	}
+}
+
+/*
+ * Crea n procesos "vacio" seguidos y después los espera
+ */
+static void lanzar_y_esperar(int n){
+	int i, estado;
+	int pids[NUM_HIJOS];
+
+	for (i=0; i<n; i++)
+		if ((pids[i]=crear_proceso("vacio"))<0)
+			printf("Error creando vacio\n");
+	for (i=0; i<n; i++)
+		if (pids[i]>=0)
+			esperar_proceso(pids[i], &estado);
+}
+
+/*
+ * Con la reserva activada casi todas las creaciones reutilizan la pila
+ * del anterior; sin ella ninguna
+ */
+static void pilas(unsigned int maximo){
+	int guardadas;
+	unsigned int aciertos, fallos, arranque;
+
+	fijar_reserva_pilas(maximo);		/* pone a cero las medidas */
+	lanzar_seguidos(NUM_ARRANQUES);
+	guardadas=obtener_reserva_pilas(&aciertos, &fallos, &arranque);
+	printf("prueba_arranque (pilas %s): %d aciertos, %d fallos, %d pilas guardadas, arranque medio %d ns\n",
+		maximo ? "con reserva" : "sin reserva", aciertos, fallos,
+		guardadas, arranque);
+	if (maximo ? aciertos==0 : aciertos!=0)
+		printf("aciertos de la reserva de pilas. NO DEBE SALIR\n");
+}
+
+/*
+ * Con la caché activada solo la primera creación carga el programa; sin
+ * ella todas
+ */
+static void imagenes(unsigned int maximo){
+	unsigned int aciertos, fallos, carga;
+
+	fijar_cache_imagenes(maximo);		/* pone a cero las medidas */
+	lanzar_seguidos(NUM_ARRANQUES);
+	obtener_cache_imagenes(&aciertos, &fallos, &carga);
+	printf("prueba_arranque (imágenes %s): %d aciertos de %d, carga media %d ns\n",
+		maximo ? "con caché" : "sin caché", aciertos, aciertos+fallos,
+		carga);
+	if (maximo ? aciertos==0 : aciertos!=0)
+		printf("aciertos de la caché de imágenes. NO DEBE SALIR\n");
+}
+
+/*
+ * Los procesos que terminan se liberan fuera de su camino de fin, así que
+ * el tiempo hasta que ejecuta el siguiente no depende de si hay que
+ * descargar el programa
+ */
+static void recogida(unsigned int maximo){
+	int recogidos;
+	unsigned int fin, liberacion;
+
+	fijar_cache_imagenes(maximo);
+	obtener_recogida(&fin, &liberacion);	/* pone a cero las medidas */
+	lanzar_seguidos(NUM_ARRANQUES);
+	recogidos=obtener_recogida(&fin, &liberacion);
+	printf("prueba_arranque (recogida %s): %d liberados, fin medio %d ns, liberación media %d ns\n",
+		maximo ? "con caché" : "sin caché", recogidos, fin, liberacion);
+	if (recogidos==0)
+		printf("no se ha liberado ningún proceso. NO DEBE SALIR\n");
+}
+
+/*
+ * Con la carga diferida cada hijo carga su programa al ejecutar, por lo
+ * que crear_proceso vuelve antes; sin ella no hay cargas diferidas
+ */
+static void diferida(unsigned int activa){
+	int cargas;
+	unsigned int creacion, carga;
+
+	dormir_ticks(2);	/* se liberan en espera los hijos anteriores */
+	fijar_carga_diferida(activa);		/* pone a cero las medidas */
+	lanzar_y_esperar(NUM_HIJOS);
+	cargas=obtener_carga_diferida(&creacion, &carga);
+	printf("prueba_arranque (carga %s): creación media %d ns, %d cargas diferidas de %d ns\n",
+		activa ? "diferida" : "al crear", creacion, cargas, carga);
+	if (cargas!=(activa ? NUM_HIJOS : 0))
+		printf("cargas diferidas. NO DEBE SALIR\n");
+}
+
+int main(){
+	int pid, estado;
+
+	lanzar_seguidos(NUM_ARRANQUES);
+
+	fijar_cache_imagenes(0);
+	pilas(0);
+	pilas(MAX_RESERVA);
+
+	imagenes(0);
+	imagenes(MAX_CACHE);
+
+	recogida(0);
+	recogida(MAX_CACHE);
+
+	/* Sin caché para que cada hijo cargue su programa */
+	fijar_cache_imagenes(0);
+	diferida(0);
+	diferida(1);
+
+	/* Un programa inexistente se detecta al crearlo o al esperarlo */
+	fijar_carga_diferida(0);
+	if (crear_proceso("no_existe")>=0)
+		printf("crear programa inexistente sin carga diferida. NO DEBE SALIR\n");
+	fijar_carga_diferida(1);
+	if ((pid=crear_proceso("no_existe"))<0)
+		printf("crear programa inexistente con carga diferida. NO DEBE SALIR\n");
+	else if (esperar_proceso(pid, &estado)<0 || estado!=-2)
+		printf("estado %d del programa inexistente. NO DEBE SALIR\n", estado);
+	fijar_carga_diferida(0);
+
+	printf("prueba_arranque: termina\n");
+	return 0;
+}
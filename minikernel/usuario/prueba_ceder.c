@@ -0,0 +1,42 @@
+/*
+ * usuario/prueba_ceder.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la cesión voluntaria de la UCP. Crea dos
+ * hijos "mudo" y cede su rodaja al segundo, que debe ejecutarse antes que
+ * el primero; después cede la UCP hasta que ambos terminan.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int i, primero, segundo;
+
+	if (ceder_a(-1)>=0)
+		printf("ceder_a a un proceso inexistente. NO DEBE APARECER\n");
+	if (ceder_a(obtener_id_pr())>=0)
+		printf("ceder_a a sí mismo. NO DEBE APARECER\n");
+
+	if ((primero=crear_proceso("mudo"))<0)
+		printf("Error creando mudo\n");
+	if ((segundo=crear_proceso("mudo"))<0)
+		printf("Error creando mudo\n");
+
+	printf("prueba_ceder: cede su rodaja a %d antes que a %d\n", segundo, primero);
+	if (ceder_a(segundo)<0)
+		printf("prueba_ceder: %d ya no está listo\n", segundo);
+
+	for (i=0; i<3; i++) {
+		printf("prueba_ceder: cede la UCP (%d)\n", i);
+		ceder_procesador();
+	}
+
+	printf("prueba_ceder: termina\n");
+	return 0;
+}
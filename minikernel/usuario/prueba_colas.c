@@ -0,0 +1,42 @@
+/*
+ * usuario/prueba_colas.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide ciclos de bloqueo y desbloqueo con colas
+ * de listos largas. Crea NUM_CICLISTAS procesos "ciclista" que, como él,
+ * se duermen un TICK CICLOS veces: en cada TICK despiertan todos a la vez
+ * y se van bloqueando uno tras otro, así que cada inserción y eliminación
+ * se hace con la cola llena. Arrancado con el núcleo compilado con
+ * -DDEPURAR_LISTAS comprueba además la coherencia de las listas.
+ */
+
+#include "servicios.h"
+
+#define NUM_CICLISTAS 200
+#define CICLOS 20	/* Los mismos que hace cada ciclista */
+#define TICK 100	/* Interrupciones de reloj por segundo */
+
+int main(){
+	int i, creados=0;
+	unsigned int inicio, t;
+
+	for (i=0; i<NUM_CICLISTAS; i++)
+		if (crear_proceso("ciclista")>=0)
+			creados++;
+
+	dormir_ticks(1);
+	inicio=dormir_hasta(0);
+	for (i=0; i<CICLOS; i++)
+		dormir_ticks(1);
+	t=dormir_hasta(0)-inicio;
+
+	printf("prueba_colas: %d procesos, %d ciclos de bloqueo y desbloqueo en %d TICKs (%d por segundo)\n",
+		creados+1, (creados+1)*CICLOS, t, (creados+1)*CICLOS*TICK/t);
+	return 0;
+}
@@ -0,0 +1,53 @@
+/*
+ * usuario/prueba_creacion.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide el ritmo de creación de procesos con la
+ * tabla de procesos llena. Crea NUM_PROCS procesos "inactivo" por lotes
+ * y mide cada lote en TICKs: con la asignación de entradas por mapa de
+ * bits el coste no debe crecer con el número de procesos vivos. También
+ * comprueba que el identificador de un proceso terminado no sirve para
+ * referirse al que reutiliza su entrada.
+ */
+
+#include "servicios.h"
+
+#define NUM_PROCS 4000
+#define LOTE 500
+#define TICK 100	/* Interrupciones de reloj por segundo */
+
+int main(){
+	int i, j, pid, viejo, estado, fallos=0;
+	unsigned int inicio, t;
+
+	/* Un hijo que termina y se recoge deja su entrada libre */
+	viejo=crear_proceso("mudo");
+	esperar_proceso(viejo, &estado);
+	pid=crear_proceso("mudo");
+	printf("prueba_creacion: la entrada de %d la ocupa ahora %d\n", viejo, pid);
+	if (ceder_a(viejo)>=0)
+		printf("ceder_a un proceso terminado. NO DEBE APARECER\n");
+	esperar_proceso(pid, &estado);
+
+	inicio=dormir_hasta(0);
+	for (i=0; i<NUM_PROCS; i+=LOTE) {
+		t=dormir_hasta(0);
+		for (j=0; j<LOTE; j++)
+			if (crear_proceso("inactivo")<0)
+				fallos++;
+		printf("prueba_creacion: %d vivos, lote de %d en %d TICKs\n",
+			i+LOTE-fallos, LOTE, dormir_hasta(0)-t);
+	}
+	t=dormir_hasta(0)-inicio;
+	if (t==0)
+		t=1;
+	printf("prueba_creacion: %d procesos en %d TICKs (%d por segundo), %d fallos\n",
+		NUM_PROCS, t, NUM_PROCS*TICK/t, fallos);
+	return 0;
+}
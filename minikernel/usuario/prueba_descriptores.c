@@ -0,0 +1,74 @@
+/*
+ * usuario/prueba_descriptores.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la tabla de descriptores de cada proceso.
+ * Crea un mutex y lo abre hasta tener NUM_DESC descriptores, muchos más de
+ * los NUM_MUT_PROC iniciales, hace lock y unlock con el último, cierra los
+ * pares y comprueba que al reabrir se reutilizan esos huecos. También
+ * abre por su nombre un mutex creado con un nombre demasiado largo.
+ */
+
+#include "servicios.h"
+
+#define NUM_DESC 64
+
+int main(){
+	int desc[NUM_DESC];
+	int i, abiertos=0, reusados=0;
+
+	printf("prueba_descriptores comienza\n");
+
+	if ((desc[0]=crear_mutex("tabla", RECURSIVO))<0) {
+		printf("error creando tabla. NO DEBE SALIR\n");
+		return -1;
+	}
+	abiertos=1;
+	for (i=1; i<NUM_DESC; i++) {
+		if ((desc[i]=abrir_mutex("tabla"))<0) {
+			printf("error abriendo tabla %d. NO DEBE SALIR\n", i);
+			break;
+		}
+		abiertos++;
+	}
+	printf("descriptores abiertos: %d (ultimo %d)\n", abiertos,
+		desc[abiertos-1]);
+
+	/* Cualquier descriptor sirve para operar sobre el mutex */
+	if (lock(desc[abiertos-1])<0 || lock(desc[0])<0)
+		printf("error en lock. NO DEBE SALIR\n");
+	if (unlock(desc[0])<0 || unlock(desc[abiertos-1])<0)
+		printf("error en unlock. NO DEBE SALIR\n");
+
+	/* Un descriptor que no se ha abierto no es válido */
+	if (lock(NUM_DESC*4)<0)
+		printf("error en lock de descriptor inexistente. DEBE SALIR\n");
+
+	/* Se cierran los pares y al reabrir se deben reutilizar */
+	for (i=0; i<abiertos; i+=2)
+		cerrar_mutex(desc[i]);
+	if (lock(desc[0])<0)
+		printf("error en lock de descriptor cerrado. DEBE SALIR\n");
+	for (i=0; i<abiertos; i+=2) {
+		int nuevo=abrir_mutex("tabla");
+
+		if (nuevo>=0 && nuevo<NUM_DESC && (nuevo%2)==0)
+			reusados++;
+	}
+	printf("descriptores reutilizados: %d de %d\n", reusados,
+		(abiertos+1)/2);
+
+	/* Un nombre largo se acorta igual al crear que al abrir */
+	if (crear_mutex("nombre_largo", NO_RECURSIVO)<0 ||
+	    abrir_mutex("nombre_largo")<0)
+		printf("error abriendo un mutex de nombre largo. NO DEBE SALIR\n");
+
+	printf("prueba_descriptores termina\n");
+	return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * usuario/prueba_donacion.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide la donación de rodaja. Con NUM_GASTADORES
+ * procesos "gastador", coge "convoy" dos veces (es recursivo) e
+ * "interno", crea NUM_ESPERAS procesos "esperador" que se bloquean en ellos
+ * y hace su sección crítica soltando primero "interno" y luego "convoy"
+ * poco a poco. Lo hace sin donación y con ella: con donación la sección
+ * crítica debe durar bastantes menos TICKs, porque el dueño pasa por
+ * delante de los gastadores mientras le queda rodaja prestada. Después
+ * comprueba que, al pasar un mutex, el esperador que lo coge hereda lo que
+ * le prestan los que siguen en cola, y en ambos casos que cada TICK
+ * prestado acaba consumido o devuelto al que lo prestó.
+ */
+
+#include "servicios.h"
+
+#define NUM_GASTADORES 4
+#define NUM_ESPERAS 4
+#define TRABAJO 30000000	/* iteraciones de cada tramo de la sección crítica */
+
+static void trabajar(){
+	int i, tot;
+	int j=3;
+
+	for (i=0; i<TRABAJO; i++)
+		tot=j*i;
+	tot--;
+}
+
+/*
+ * Cuando ya han terminado todos los esperadores, lo prestado no puede
+ * haber crecido: cada TICK se ha consumido o ha vuelto al que lo prestó
+ */
+static void comprobar_prestamos(){
+	unsigned int prestados, adelantados, devueltos;
+	int rodaja, pendiente;
+
+	obtener_donacion(&prestados, &adelantados, &devueltos, &rodaja, &pendiente);
+	if (prestados!=adelantados+devueltos)
+		printf("%d TICKs prestados, %d consumidos y %d devueltos. NO DEBE SALIR\n",
+			prestados, adelantados, devueltos);
+}
+
+static void fase(int activa, int convoy, int interno){
+	int pids[NUM_GASTADORES+NUM_ESPERAS];
+	unsigned int prestados, adelantados, devueltos;
+	int i, estado, inicio, fin, n, rodaja, pendiente;
+
+	fijar_donacion(activa);
+
+	lock(convoy);
+	lock(convoy);
+	lock(interno);
+	for (i=0; i<NUM_ESPERAS; i++)
+		pids[NUM_GASTADORES+i]=crear_proceso("esperador");
+	for (i=0; i<NUM_GASTADORES; i++)
+		pids[i]=crear_proceso("gastador");
+
+	/* Deja que los esperadores se bloqueen */
+	inicio=dormir_ticks(20);
+
+	trabajar();
+	unlock(interno);	/* sigue teniendo convoy: conserva su préstamo */
+	trabajar();
+	unlock(convoy);		/* recursivo: aún lo tiene */
+	trabajar();
+	fin=dormir_hasta(0);
+	unlock(convoy);		/* lo suelta del todo y pasa al primer esperador */
+
+	n=obtener_donacion(&prestados, &adelantados, &devueltos, &rodaja, &pendiente);
+	printf("%s donación: sección crítica de %d TICKs, %d préstamos de %d TICKs, %d consumidos\n",
+		activa ? "con" : "sin", fin-inicio, n, prestados, adelantados);
+
+	for (i=0; i<NUM_GASTADORES+NUM_ESPERAS; i++)
+		esperar_proceso(pids[i], &estado);
+	comprobar_prestamos();
+}
+
+/*
+ * Sin gastadores y soltando los mutex en cuanto se bloquean los
+ * esperadores, lo prestado apenas se consume: en cada mutex todos los
+ * esperadores salvo el último heredan al cogerlo lo que prestan los que
+ * siguen en cola, y terminan con estado 1
+ */
+static void relevo(int convoy, int interno){
+	int pids[NUM_ESPERAS];
+	int i, estado, en_convoy=0, herederos=0, esperados;
+
+	fijar_donacion(1);
+
+	lock(convoy);
+	lock(interno);
+	for (i=0; i<NUM_ESPERAS; i++) {
+		if ((pids[i]=crear_proceso("esperador"))<0)
+			printf("Error creando esperador\n");
+		else if (pids[i]%2==0)
+			en_convoy++;
+	}
+	dormir_ticks(20);
+	unlock(interno);
+	unlock(convoy);
+
+	for (i=0; i<NUM_ESPERAS; i++)
+		if (pids[i]>=0 && esperar_proceso(pids[i], &estado)==0 && estado==1)
+			herederos++;
+	esperados=(en_convoy>1 ? en_convoy-1 : 0) +
+		(NUM_ESPERAS-en_convoy>1 ? NUM_ESPERAS-en_convoy-1 : 0);
+	printf("prueba_donacion: %d de %d esperadores heredan al coger el mutex\n",
+		herederos, NUM_ESPERAS);
+	if (herederos!=esperados)
+		printf("se pierde lo heredado al pasar el mutex. NO DEBE SALIR\n");
+	comprobar_prestamos();
+}
+
+int main(){
+	int convoy, interno;
+
+	printf("prueba_donacion comienza\n");
+
+	if ((convoy=crear_mutex("convoy", RECURSIVO))<0 ||
+	    (interno=crear_mutex("interno", NO_RECURSIVO))<0) {
+		printf("error creando los mutex. NO DEBE SALIR\n");
+		return -1;
+	}
+
+	fase(0, convoy, interno);
+	fase(1, convoy, interno);
+	relevo(convoy, interno);
+
+	printf("prueba_donacion termina\n");
+	return 0;
+}
@@ -0,0 +1,58 @@
+/*
+ * usuario/prueba_espera.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la espera a los hijos. Crea NUM_HIJOS
+ * procesos "salida" y espera a cada uno comprobando su estado de salida:
+ * debe acabar en unos pocos TICKs, no en el segundo que se dormiría para
+ * dar tiempo a que terminen. También comprueba el estado de un hijo que
+ * sufre una excepción, el de uno que termina antes de esperarlo y que no
+ * se puede esperar a quien no es hijo ni dos veces al mismo.
+ */
+
+#include "servicios.h"
+
+#define NUM_HIJOS 20
+#define MODULO 100	/* El de salida */
+
+int main(){
+	int i, pid, estado, fallos=0;
+	int pids[NUM_HIJOS];
+	unsigned int inicio;
+
+	inicio=dormir_hasta(0);
+	for (i=0; i<NUM_HIJOS; i++)
+		if ((pids[i]=crear_proceso("salida"))<0)
+			printf("Error creando salida\n");
+	for (i=0; i<NUM_HIJOS; i++)
+		if (esperar_proceso(pids[i], &estado)<0 || estado!=pids[i]%MODULO)
+			fallos++;
+	printf("prueba_espera: %d hijos esperados en %d TICKs, %d estados erróneos\n",
+		NUM_HIJOS, dormir_hasta(0)-inicio, fallos);
+
+	/* Un hijo que ya ha terminado queda a la espera de que se recoja */
+	pid=crear_proceso("salida");
+	dormir_ticks(10);
+	if (esperar_proceso(pid, &estado)<0 || estado!=pid%MODULO)
+		printf("error esperando a un hijo terminado. NO DEBE APARECER\n");
+	if (esperar_proceso(pid, &estado)>=0)
+		printf("esperar dos veces al mismo hijo. NO DEBE APARECER\n");
+
+	pid=crear_proceso("excep_arit");
+	if (esperar_proceso(pid, &estado)<0 || estado!=-1)
+		printf("error esperando a un hijo con excepción. NO DEBE APARECER\n");
+	else
+		printf("prueba_espera: el hijo con excepción termina con estado %d\n", estado);
+
+	if (esperar_proceso(obtener_id_pr(), &estado)>=0)
+		printf("esperar a un proceso que no es hijo. NO DEBE APARECER\n");
+
+	printf("prueba_espera: termina\n");
+	return 0;
+}
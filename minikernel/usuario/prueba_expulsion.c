@@ -0,0 +1,36 @@
+/*
+ * usuario/prueba_expulsion.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la expulsión al despertar. Duerme varias
+ * veces mientras sus hijos "consumidor" ocupan la UCP. Con la regla por
+ * defecto, en MLFQ cada despertar debe expulsar al consumidor en ejecución,
+ * porque sube de cola al bloquearse sin agotar su rodaja; en round robin
+ * eso solo ocurre con MINIKERNEL_EXPULSION=sueno. Con
+ * MINIKERNEL_EXPULSION=nunca debe esperar a que agote su rodaja.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int i;
+
+	if (crear_proceso("consumidor")<0)
+		printf("Error creando consumidor\n");
+	if (crear_proceso("consumidor")<0)
+		printf("Error creando consumidor\n");
+
+	for (i=0; i<3; i++) {
+		dormir(1);
+		printf("prueba_expulsion: despierta (%d)\n", i);
+	}
+
+	printf("prueba_expulsion: termina\n");
+	return 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * usuario/prueba_grupos.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la cuota de UCP por grupos. Crea un
+ * "consumidor" sin límite y otros dos dentro de un grupo con una cuota
+ * de 30 TICKs cada 100: entre los dos del grupo no deben pasar del 30%
+ * de la UCP mientras el primero siga compitiendo. Desde el grupo no se
+ * puede crear otro.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int i, grupo;
+	unsigned int consumo, estrangulamientos;
+
+	if (crear_grupo(200, 100)>=0)
+		printf("cuota mayor que el periodo. NO DEBE APARECER\n");
+
+	if (crear_proceso("consumidor")<0)
+		printf("Error creando consumidor\n");
+
+	if ((grupo=crear_grupo(30, 100))<0)
+		printf("Error creando grupo\n");
+
+	/* Ya tiene cuota: no puede escapar de ella con otro grupo */
+	if (crear_grupo(100, 100)>=0)
+		printf("crear_grupo desde un grupo con cuota. NO DEBE APARECER\n");
+
+	/* Los hijos heredan el grupo */
+	for (i=0; i<2; i++)
+		if (crear_proceso("consumidor")<0)
+			printf("Error creando consumidor\n");
+
+	for (i=0; i<5; i++) {
+		dormir(1);
+		obtener_uso_grupo(grupo, &consumo, &estrangulamientos);
+		printf("prueba_grupos: grupo %d consumo %d TICKs, %d estrangulamientos\n",
+			grupo, consumo, estrangulamientos);
+	}
+
+	printf("prueba_grupos: termina\n");
+	return 0;
+}
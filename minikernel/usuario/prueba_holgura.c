@@ -0,0 +1,43 @@
+/*
+ * usuario/prueba_holgura.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la holgura de los temporizadores. Crea
+ * varios "holgazan" sin holgura y después otros tantos con ella: solo en
+ * la segunda tanda deben agruparse los despertares en TICKs compartidos.
+ */
+
+#include "servicios.h"
+
+#define HIJOS 4
+#define HOLGURA 16
+
+static void tanda(int holgura){
+	int i;
+	unsigned int agrupados, ahorradas;
+
+	fijar_holgura(holgura);
+	for (i=0; i<HIJOS; i++)
+		if (crear_proceso("holgazan")<0)
+			printf("Error creando holgazan\n");
+
+	/* Sin holgura propia para no alterar la medida */
+	fijar_holgura(0);
+	dormir(2);
+	obtener_agrupamiento(&agrupados, &ahorradas);
+	printf("prueba_holgura: holgura %d, %d despertares agrupados, %d pasadas del planificador ahorradas\n",
+		holgura, agrupados, ahorradas);
+}
+
+int main(){
+	tanda(0);
+	tanda(HOLGURA);
+	printf("prueba_holgura: termina\n");
+	return 0;
+}
@@ -0,0 +1,60 @@
+/*
+ * usuario/prueba_lotes.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que compara el arranque de una flota de procesos
+ * creados uno a uno con crear_proceso y por lotes con crear_procesos. Los
+ * "inactivo" de la primera flota duermen 10 segundos, así que se espera a
+ * que terminen antes de crear la segunda. Antes comprueba que, sin caché
+ * de imágenes, un lote carga el programa una sola vez.
+ */
+
+#include "servicios.h"
+
+#define NUM_PROCS 4000
+#define LOTE 100
+
+int main(){
+	int i, creados, estado, pids[LOTE];
+	unsigned int inicio, t, aciertos, fallos, carga;
+
+	fijar_cache_imagenes(0);		/* pone a cero las medidas */
+	creados=crear_procesos("vacio", LOTE, pids);
+	obtener_cache_imagenes(&aciertos, &fallos, &carga);
+	printf("prueba_lotes: lote de %d sin caché con %d cargas y %d imágenes compartidas\n",
+		creados, fallos, aciertos);
+	if (creados!=LOTE || fallos!=1 || aciertos!=LOTE-1)
+		printf("el lote no comparte una sola imagen. NO DEBE APARECER\n");
+	for (i=0; i<creados; i++)
+		esperar_proceso(pids[i], &estado);
+
+	inicio=dormir_hasta(0);
+	for (i=0, creados=0; i<NUM_PROCS; i++)
+		if (crear_proceso("inactivo")>=0)
+			creados++;
+	t=dormir_hasta(0)-inicio;
+	printf("prueba_lotes: %d procesos uno a uno en %d llamadas y %d TICKs\n",
+		creados, NUM_PROCS, t);
+
+	dormir(12);
+
+	inicio=dormir_hasta(0);
+	for (i=0, creados=0; i<NUM_PROCS; i+=LOTE)
+		creados+=crear_procesos("inactivo", LOTE, pids);
+	t=dormir_hasta(0)-inicio;
+	printf("prueba_lotes: %d procesos por lotes en %d llamadas y %d TICKs\n",
+		creados, NUM_PROCS/LOTE, t);
+	printf("prueba_lotes: el último lote va del %d al %d\n", pids[0], pids[LOTE-1]);
+
+	if (crear_procesos("inactivo", 0, pids)>=0)
+		printf("lote vacío. NO DEBE APARECER\n");
+	if (crear_procesos("no_existe", 2, pids)>=0)
+		printf("lote de un programa inexistente. NO DEBE APARECER\n");
+	return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * usuario/prueba_nombres.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide la apertura de mutex por nombre con muchos
+ * mutex en el sistema. Crea procesos "poseedor" que mantienen
+ * POR_POSEEDOR mutex cada uno, tantos como quepan hasta NUM_POSEEDORES, y
+ * abre y cierra VUELTAS veces cada nombre. Con el índice de nombres la
+ * búsqueda no debe crecer con el número de mutex. El sistema tiene NUM_MUT
+ * mutex salvo que se arranque con MINIKERNEL_MAX_MUTEX, por ejemplo 4096.
+ */
+
+#include "servicios.h"
+
+#define NUM_POSEEDORES 1000
+#define POR_POSEEDOR 3
+#define VUELTAS 10
+#define TICK 100	/* Interrupciones de reloj por segundo */
+
+static int pids[NUM_POSEEDORES];
+
+/* Nombre del mutex k del poseedor pid: "p", el pid en base 36 y una letra */
+static void nombre_mutex(char *nombre, int pid, int k){
+	char cifras[8];
+	int n=0;
+
+	do {
+		cifras[n++]="0123456789abcdefghijklmnopqrstuvwxyz"[pid%36];
+		pid/=36;
+	} while (pid>0);
+	*nombre++='p';
+	while (n>0)
+		*nombre++=cifras[--n];
+	*nombre++='a'+k;
+	*nombre='\0';
+}
+
+int main(){
+	char nombre[8];
+	int i, k, v, desc, barrera, estado, poseedores, fallos=0;
+	unsigned int busquedas, busqueda, inicio, t;
+
+	/* Uno de los mutex del sistema es la barrera */
+	poseedores=(obtener_nombres_mutex(&busquedas, &busqueda) - 1)/POR_POSEEDOR;
+	if (poseedores>NUM_POSEEDORES)
+		poseedores=NUM_POSEEDORES;
+
+	if ((barrera=crear_mutex("barrera", NO_RECURSIVO))<0 || lock(barrera)<0) {
+		printf("prueba_nombres: error con la barrera\n");
+		return 1;
+	}
+	for (i=0; i<poseedores; i++)
+		if ((pids[i]=crear_proceso("poseedor"))<0)
+			printf("Error creando poseedor\n");
+
+	/* Espera a que todos hayan creado sus mutex */
+	for (i=0; i<poseedores; i++)
+		for (k=0; k<POR_POSEEDOR; k++) {
+			nombre_mutex(nombre, pids[i], k);
+			while ((desc=abrir_mutex(nombre))<0)
+				dormir_ticks(1);
+			cerrar_mutex(desc);
+		}
+
+	obtener_nombres_mutex(&busquedas, &busqueda);	/* pone a cero las medidas */
+	inicio=dormir_hasta(0);
+	for (v=0; v<VUELTAS; v++)
+		for (i=0; i<poseedores; i++) {
+			nombre_mutex(nombre, pids[i], v%POR_POSEEDOR);
+			if ((desc=abrir_mutex(nombre))<0)
+				fallos++;
+			else
+				cerrar_mutex(desc);
+		}
+	t=dormir_hasta(0)-inicio;
+	obtener_nombres_mutex(&busquedas, &busqueda);
+	if (t==0)
+		t=1;
+	printf("prueba_nombres: %d mutex, %d aperturas en %d TICKs (%d por segundo), búsqueda media %d ns, %d fallos\n",
+		poseedores*POR_POSEEDOR+1, VUELTAS*poseedores, t,
+		VUELTAS*poseedores*TICK/t, busqueda, fallos);
+
+	/* Los poseedores terminan al pasar por la barrera */
+	cerrar_mutex(barrera);
+	for (i=0; i<poseedores; i++)
+		esperar_proceso(pids[i], &estado);
+	printf("prueba_nombres: termina\n");
+	return 0;
+}
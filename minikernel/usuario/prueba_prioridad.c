@@ -0,0 +1,39 @@
+/*
+ * usuario/prueba_prioridad.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de las prioridades estáticas.
+ * Crea procesos "mudo" que heredan prioridades distintas: deben terminar
+ * en orden de prioridad y no de creación.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int prio;
+
+	printf("prueba_prioridad: comienza con prioridad %d\n", obtener_prioridad());
+
+	if (fijar_prioridad(100)>=0)
+		printf("fijar prioridad fuera de rango. NO DEBE APARECER\n");
+
+	/* Se crea un hijo por prioridad, del menos al más prioritario */
+	for (prio=6; prio>=2; prio-=2) {
+		fijar_prioridad(prio);
+		if (crear_proceso("mudo")<0)
+			printf("Error creando mudo\n");
+		else
+			printf("prueba_prioridad: creado mudo con prioridad %d\n", prio);
+	}
+
+	/* Con la máxima prioridad el padre termina antes que sus hijos */
+	fijar_prioridad(0);
+	printf("prueba_prioridad: termina. Los mudo deben terminar en orden inverso al de creación\n");
+	return 0;
+}
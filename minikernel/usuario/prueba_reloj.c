@@ -0,0 +1,50 @@
+/*
+ * usuario/prueba_reloj.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que muestra el ahorro de la frecuencia de reloj
+ * dinámica (arrancar con MINIKERNEL_RELOJ=dinamico). Solo en la UCP y
+ * dormido el reloj debe ir lento; con dos hijos "mudo" compitiendo debe
+ * volver a la frecuencia normal.
+ */
+
+#include "servicios.h"
+
+#define TOT_ITER 50000000
+
+static void mostrar(char *fase){
+	unsigned int evitadas, tranquilos;
+	int hz;
+
+	hz=obtener_ahorro_reloj(&evitadas, &tranquilos);
+	printf("prueba_reloj (%s): reloj a %d Hz, %d interrupciones evitadas, %d por el camino rápido\n",
+		fase, hz, evitadas, tranquilos);
+}
+
+int main(){
+	int i, tot=0;
+
+	mostrar("inicio");
+
+	for (i=0; i<TOT_ITER; i++)
+		tot+=i;
+	mostrar("solo en la UCP");
+
+	crear_proceso("mudo");
+	crear_proceso("mudo");
+	for (i=0; i<TOT_ITER; i++)
+		tot+=i;
+	mostrar("con competencia");
+
+	dormir(5);
+	mostrar("tras dormir");
+
+	printf("prueba_reloj: termina (%d)\n", tot);
+	return 0;
+}
@@ -0,0 +1,50 @@
+/*
+ * usuario/prueba_rodaja.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que muestra la evolución de la rodaja adaptativa
+ * (arrancar con MINIKERNEL_PLANIF=adaptive). En la fase de cálculo la
+ * rodaja debe crecer hasta el máximo y en la de E/S, simulada con dormir,
+ * debe reducirse hasta el mínimo.
+ */
+
+#include "servicios.h"
+
+#define TOT_ITER 20000000
+
+static void mostrar(char *fase){
+	unsigned int historia[QUANTUM_HIST];
+	int i, rodaja;
+
+	rodaja=obtener_rodaja(historia);
+	printf("prueba_rodaja (%s): rodaja actual %d, historial", fase, rodaja);
+	for (i=0; i<QUANTUM_HIST; i++)
+		printf(" %d", historia[i]);
+	printf("\n");
+}
+
+int main(){
+	int i, j, tot=0;
+
+	mostrar("inicio");
+
+	/* Fase intensiva en UCP */
+	for (i=0; i<5; i++)
+		for (j=0; j<TOT_ITER; j++)
+			tot+=j;
+	mostrar("cálculo");
+
+	/* Fase intensiva en E/S */
+	for (i=0; i<5; i++)
+		dormir(1);
+	mostrar("E/S");
+
+	printf("prueba_rodaja: termina (%d)\n", tot);
+	return 0;
+}
@@ -0,0 +1,47 @@
+/*
+ * usuario/prueba_rueda.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide el coste por TICK del tratamiento de los
+ * procesos dormidos. Crea tantos "durmiente" como admita la tabla de
+ * procesos (hasta MAX_DURMIENTES) y compara los procesos que trata la
+ * rueda de temporización con los que habría recorrido una lista.
+ */
+
+#include "servicios.h"
+
+#define MAX_DURMIENTES 500
+
+int main(){
+	int i, n, dormidos;
+	unsigned int ticks, visitas, lineal;
+	unsigned int ticks0, visitas0, lineal0;
+
+	for (n=0; n<MAX_DURMIENTES; n++)
+		if (crear_proceso("durmiente")<0)
+			break;
+	printf("prueba_rueda: creados %d durmientes\n", n);
+
+	obtener_coste_dormir(&ticks0, &visitas0, &lineal0);
+	for (i=0; i<4; i++) {
+		dormir(2);
+		dormidos=obtener_coste_dormir(&ticks, &visitas, &lineal);
+		ticks-=ticks0;
+		visitas-=visitas0;
+		lineal-=lineal0;
+		if (ticks==0)
+			continue;
+		printf("prueba_rueda: %d dormidos, %d TICKs, rueda %d.%02d procesos/TICK, lista %d.%02d procesos/TICK\n",
+			dormidos, ticks, visitas/ticks, (visitas*100/ticks)%100,
+			lineal/ticks, (lineal*100/ticks)%100);
+	}
+
+	printf("prueba_rueda: termina\n");
+	return 0;
+}
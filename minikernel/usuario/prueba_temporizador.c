@@ -0,0 +1,51 @@
+/*
+ * usuario/prueba_temporizador.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba las esperas con resolución de TICK y
+ * los temporizadores periódicos. Los vencimientos del temporizador deben
+ * caer siempre en múltiplos exactos del periodo desde su creación; en la
+ * vuelta en la que se calcula de más deben notificarse periodos perdidos.
+ */
+
+#include "servicios.h"
+
+#define PERIODO 10
+#define TOT_ITER 150000000
+
+int main(){
+	int i, j, t, tot=0, perdidos, inicio, ahora;
+
+	inicio=dormir_hasta(0);
+	ahora=dormir_ticks(5);
+	printf("prueba_temporizador: dormir_ticks(5) desde %d despierta en %d\n", inicio, ahora);
+	ahora=dormir_hasta(inicio+20);
+	printf("prueba_temporizador: dormir_hasta(%d) despierta en %d\n", inicio+20, ahora);
+
+	if (esperar_temporizador(-1)>=0)
+		printf("temporizador inexistente. NO DEBE APARECER\n");
+
+	inicio=dormir_hasta(0);
+	if ((t=crear_temporizador(PERIODO))<0)
+		printf("Error creando temporizador\n");
+
+	for (i=0; i<6; i++) {
+		/* En la tercera vuelta el trabajo dura más de un periodo */
+		if (i==2)
+			for (j=0; j<TOT_ITER; j++)
+				tot+=j;
+		perdidos=esperar_temporizador(t);
+		ahora=dormir_hasta(0);
+		printf("prueba_temporizador: vencimiento en %d (+%d), %d periodos perdidos\n",
+			ahora, ahora-inicio, perdidos);
+	}
+
+	printf("prueba_temporizador: termina (%d)\n", tot);
+	return 0;
+}
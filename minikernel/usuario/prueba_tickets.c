@@ -0,0 +1,36 @@
+/*
+ * usuario/prueba_tickets.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba del reparto proporcional
+ * de UCP (políticas stride y lottery). Crea procesos "consumidor" con
+ * 100, 200 y 300 tickets: cada uno debe recibir una fracción de UCP
+ * próxima a la que le corresponde por sus tickets.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int tickets;
+
+	printf("prueba_tickets: comienza\n");
+
+	if (fijar_tickets(0)>=0)
+		printf("fijar 0 tickets. NO DEBE APARECER\n");
+
+	/* Los hijos heredan los tickets del creador */
+	for (tickets=100; tickets<=300; tickets+=100) {
+		fijar_tickets(tickets);
+		if (crear_proceso("consumidor")<0)
+			printf("Error creando consumidor\n");
+	}
+
+	printf("prueba_tickets: termina\n");
+	return 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * usuario/prueba_tiempo_real.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de la clase de tiempo real.
+ * Crea dos procesos "periodico", que deben cumplir sus plazos pese a
+ * competir con un proceso "consumidor", y comprueba que la prueba de
+ * admisión rechaza un conjunto que no es planificable.
+ */
+
+#include "servicios.h"
+
+int main(){
+
+	printf("prueba_tiempo_real: comienza\n");
+
+	if (crear_proceso("consumidor")<0)
+		printf("Error creando consumidor\n");
+
+	if (crear_proceso("periodico")<0)
+		printf("Error creando periodico\n");
+
+	if (crear_proceso("periodico")<0)
+		printf("Error creando periodico\n");
+
+	/* Presupuesto mayor que el plazo -> error */
+	if (fijar_tiempo_real(20, 30, 20)<0)
+		printf("parametros de tiempo real erroneos. DEBE APARECER\n");
+
+	/* Utilización del 100% -> rechazado por la prueba de admisión */
+	if (fijar_tiempo_real(10, 10, 10)<0)
+		printf("proceso de tiempo real rechazado. DEBE APARECER\n");
+
+	/* También con un presupuesto cuyo producto por mil no cabe en 32 bits */
+	if (fijar_tiempo_real(5000000, 5000000, 0)<0)
+		printf("proceso de tiempo real enorme rechazado. DEBE APARECER\n");
+	else
+		printf("proceso de tiempo real enorme admitido. NO DEBE APARECER\n");
+
+	if (esperar_periodo()<0)
+		printf("esperar periodo sin ser de tiempo real. DEBE APARECER\n");
+
+	printf("prueba_tiempo_real: termina\n");
+	return 0;
+}
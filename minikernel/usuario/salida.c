@@ -0,0 +1,22 @@
+/*
+ * usuario/salida.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que termina con un estado de salida que depende de
+ * su identificador, para que quien lo espere pueda comprobarlo
+ */
+
+#include "servicios.h"
+
+#define MODULO 100
+
+int main(){
+	salir(obtener_id_pr() % MODULO);
+	return 0;	/* no debería llegar aquí */
+}
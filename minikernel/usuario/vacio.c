@@ -0,0 +1,20 @@
+/*
+ * usuario/vacio.c
+ *
+ *  Minikernel. Versi�n 1.0
+ *
+ *  Fernando P�rez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que termina nada más empezar. La llamada explícita
+ * a terminar_proceso enlaza la biblioteca, que aporta el arranque.
+ */
+
+#include "servicios.h"
+
+int main(){
+	terminar_proceso();
+	return 0;
+}